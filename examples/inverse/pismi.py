@@ -406,12 +406,19 @@ def run():
     vecs.add(zeta_prior, writing=True)
 
     # Determine the initial guess for zeta.  If we are restarting, load it from
-    # the output file.  Otherwise, if 'zeta_inv' is in the inverse data file, use it.
-    # If none of the above, copy from 'zeta_prior'.
+    # the checkpoint file (if present) or the output file.  Otherwise, if 'zeta_inv'
+    # is in the inverse data file, use it.  If none of the above, copy from 'zeta_prior'.
     zeta = PISM.IceModelVec2S()
     zeta.create(grid, "zeta_inv", PISM.WITH_GHOSTS, WIDE_STENCIL)
     zeta.set_attrs("diagnostic", "zeta_inv", "1", "1", "zeta_inv", 0)
-    if do_restart:
+    checkpoint = None
+    checkpoint_filename = config.get_string("inverse.checkpoint.file")
+    if do_restart and os.path.exists(checkpoint_filename):
+        checkpoint = PISM.invert.ssa.readCheckpoint(grid, checkpoint_filename)
+        PISM.logging.logMessage("  Inversion restarting from iteration %d saved in %s\n" %
+                                (checkpoint.iteration, checkpoint_filename))
+        zeta.copy_from(checkpoint.zeta)
+    elif do_restart:
         # Just to be sure, verify that we have a 'zeta_inv' in the output file.
         if not PISM.util.fileHasVariable(output_filename, 'zeta_inv'):
             PISM.verbPrintf(
@@ -495,6 +502,12 @@ def run():
     # Saving the current iteration
     solver.addDesignUpdateListener(PISM.invert.ssa.ZetaSaver(output_filename))
 
+    # Checkpointing
+    if config.get_number("inverse.checkpoint.interval") > 0:
+        solver.addIterationListener(PISM.invert.ssa.InversionCheckpointer(grid, checkpoint))
+    if checkpoint is not None:
+        solver.setRestart(checkpoint)
+
     # Plotting
     if do_plotting:
         solver.addIterationListener(InvSSAPlotListener(grid, Vmax))
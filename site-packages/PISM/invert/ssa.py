@@ -236,6 +236,13 @@ class InvSSASolver(object):
         self.ssarun = ssarun
         self.config = ssarun.config
         self.method = method
+        self.restart = None
+
+    def setRestart(self, checkpoint):
+        """Resume an inversion using data read from a checkpoint (see :func:`readCheckpoint`).
+        Solvers that do not support restarting ignore the iteration counter and the
+        quasi-Newton history and use the saved :math:`\zeta` only."""
+        self.restart = checkpoint
 
     def solveForward(self, zeta, out=None):
         r"""Given a parameterized design variable value :math:`\zeta`, solve the SSA.
@@ -596,3 +603,111 @@ class ZetaSaver(object):
         zeta.metadata().set_string('long_name',
                                    'last iteration of parameterized basal yeild stress computed by inversion')
         zeta.write(self.output_filename)
+
+
+class InversionCheckpointer(object):
+    r"""Iteration listener saving inversion checkpoints.
+
+    Every ``inverse.checkpoint.interval`` iterations it writes the current value of
+    :math:`\zeta`, the corresponding SSA velocity, the iteration counter and the last
+    ``inverse.checkpoint.history_length`` iterates and gradients of the Tikhonov
+    functional (used to rebuild the L-BFGS approximation of the Hessian) to
+    ``inverse.checkpoint.file``. Use :func:`readCheckpoint` to resume.
+    """
+
+    def __init__(self, grid, checkpoint=None):
+        """:param grid: the computational grid
+           :param checkpoint: checkpoint the current inversion was restarted from (optional)."""
+        config = grid.ctx().config()
+        self.grid = grid
+        self.filename = config.get_string("inverse.checkpoint.file")
+        self.interval = int(config.get_number("inverse.checkpoint.interval"))
+        self.history_length = int(config.get_number("inverse.checkpoint.history_length"))
+
+        self.zeta = PISM.IceModelVec2S(grid, "zeta_inv", PISM.WITHOUT_GHOSTS)
+        self.zeta.set_attrs("diagnostic", "zeta_inv", "1", "1", "zeta_inv", 0)
+        self.u = PISM.model.create2dVelocityVec(grid, "_ssa_inv", "SSA velocity computed by inversion",
+                                                ghost_type=PISM.WITHOUT_GHOSTS)
+
+        self.history = []
+        self.last_iteration = -1
+        if checkpoint is not None:
+            for zeta, gradient in checkpoint.history:
+                self._record(zeta, gradient)
+            self.last_iteration = checkpoint.iteration
+
+    def _record(self, zeta, gradient):
+        "Add a pair (iterate, gradient) to the history, re-using storage of the oldest pair."
+        if len(self.history) < self.history_length:
+            pair = (PISM.IceModelVec2S(self.grid, "zeta_history", PISM.WITHOUT_GHOSTS),
+                    PISM.IceModelVec2S(self.grid, "gradient_history", PISM.WITHOUT_GHOSTS))
+        else:
+            pair = self.history.pop(0)
+        pair[0].copy_from(zeta)
+        pair[1].copy_from(gradient)
+        self.history.append(pair)
+
+    def __call__(self, inverse_solver, count, data):
+        # Skip iterations that are already saved (e.g. iteration 0 after a restart).
+        if count <= self.last_iteration:
+            return
+        self.last_iteration = count
+
+        if self.history_length > 0 and 'grad_JTikhonov' in data:
+            self._record(data.zeta, data.grad_JTikhonov)
+
+        if self.interval > 0 and count % self.interval == 0:
+            self.write(count, data.zeta, data.u)
+
+    def write(self, count, zeta, u):
+        """Write a checkpoint. An existing checkpoint file is kept (renamed by appending
+        ``~``) until the new one is written."""
+        output = PISM.util.prepare_output(self.filename)
+        output.write_attribute("PISM_GLOBAL", "inverse_iteration", PISM.PISM_INT, [count])
+        output.write_attribute("PISM_GLOBAL", "inverse_history_length", PISM.PISM_INT,
+                               [len(self.history)])
+        output.close()
+
+        self.zeta.copy_from(zeta)
+        self.zeta.write(self.filename)
+
+        self.u.copy_from(u)
+        self.u.write(self.filename)
+
+        for k, (z, g) in enumerate(self.history):
+            z.metadata().set_name("zeta_history_%d" % k)
+            z.write(self.filename)
+            g.metadata().set_name("gradient_history_%d" % k)
+            g.write(self.filename)
+
+        logMessage("Saved inversion checkpoint (iteration %d) to %s\n" % (count, self.filename))
+
+
+def readCheckpoint(grid, filename):
+    """Read an inversion checkpoint written by :class:`InversionCheckpointer`.
+
+    :param grid: the computational grid
+    :param filename: the checkpoint file
+    :returns: a :class:`PISM.util.Bunch` with fields ``iteration``, ``zeta``, ``u`` and
+              ``history`` (a list of pairs of iterates and gradients, oldest first).
+    """
+    nc = PISM.File(grid.com, filename, PISM.PISM_NETCDF3, PISM.PISM_READONLY)
+    iteration = int(nc.read_double_attribute("PISM_GLOBAL", "inverse_iteration")[0])
+    history_length = int(nc.read_double_attribute("PISM_GLOBAL", "inverse_history_length")[0])
+    nc.close()
+
+    zeta = PISM.IceModelVec2S(grid, "zeta_inv", PISM.WITHOUT_GHOSTS)
+    zeta.regrid(filename, critical=True)
+
+    u = PISM.model.create2dVelocityVec(grid, "_ssa_inv", ghost_type=PISM.WITHOUT_GHOSTS)
+    u.regrid(filename, critical=True)
+
+    history = []
+    for k in range(history_length):
+        z = PISM.IceModelVec2S(grid, "zeta_history_%d" % k, PISM.WITHOUT_GHOSTS)
+        z.regrid(filename, critical=True)
+        g = PISM.IceModelVec2S(grid, "gradient_history_%d" % k, PISM.WITHOUT_GHOSTS)
+        g.regrid(filename, critical=True)
+        history.append((z, g))
+
+    return PISM.util.Bunch(iteration=iteration, zeta=zeta, u=u, history=history)
@@ -125,6 +125,17 @@ class InvSSASolver_Tikhonov(InvSSASolver):
         self.solver = solverClass(self.ssarun.grid.com, tao_type, self.ip)
 
         max_it = int(self.config.get_number("inverse.max_iterations"))
+
+        if self.restart is not None:
+            # Warm-start the first forward solve.
+            self.ssarun.ssa.set_initial_guess(self.restart.u)
+
+            if self.method != 'tikhonov_lcl':
+                self.ip.setIterationOffset(self.restart.iteration)
+                for zeta, gradient in self.restart.history:
+                    self.ip.addQuasiNewtonHistory(zeta, gradient)
+                max_it = max(max_it - self.restart.iteration, 0)
+
         self.solver.setMaximumIterations(max_it)
 
         pl = [listenerClass(self, l) for l in self.listeners]
@@ -30,12 +30,13 @@ AgeModelInputs::AgeModelInputs(const IceModelVec2S *thickness,
                                const IceModelVec3 *u,
                                const IceModelVec3 *v,
                                const IceModelVec3 *w)
-  : ice_thickness(thickness), u3(u), v3(v), w3(w) {
+  : ice_thickness(thickness), cell_type(NULL), u3(u), v3(v), w3(w) {
   // empty
 }
 
 AgeModelInputs::AgeModelInputs() {
   ice_thickness = NULL;
+  cell_type     = NULL;
   u3            = NULL;
   v3            = NULL;
   w3            = NULL;
@@ -59,16 +60,13 @@ AgeModel::AgeModel(IceGrid::ConstPtr grid, stressbalance::StressBalance *stress_
   : Component(grid),
     // FIXME: should be able to use width=1...
     m_ice_age(m_grid, "age", WITH_GHOSTS, m_config->get_number("grid.max_stencil_width")),
-    m_work(m_grid, "work_vector", WITHOUT_GHOSTS),
+    m_work(m_grid, "work_vector"),
     m_stress_balance(stress_balance) {
 
   m_ice_age.set_attrs("model_state", "age of ice",
                       "s", "years", "" /* no standard name*/, 0);
 
   m_ice_age.metadata().set_number("valid_min", 0.0);
-
-  m_work.set_attrs("internal", "new values of age during time step",
-                   "s", "s", "", 0);
 }
 
 /*!
@@ -128,17 +126,26 @@ void AgeModel::update(double t, double dt, const AgeModelInputs &inputs) {
 
   IceModelVec::AccessList list{&ice_thickness, &u3, &v3, &w3, &m_ice_age, &m_work};
 
-  unsigned int Mz = m_grid->Mz();
+  m_active_columns.update(ice_thickness, inputs.cell_type);
+
+  // Age above the ice surface is zero (see AgeColumnSystem::solve()), so only levels in
+  // the ice are stored.
+  m_work.update_columns(ice_thickness, 0.0);
+
+  // if no ice, set the entire column to zero age
+  for (ColumnPoints p(m_active_columns.ice_free()); p; p.next()) {
+    m_work.set_column(p.i(), p.j(), 0.0);
+  }
 
   ParallelSection loop(m_grid->com);
   try {
-    for (Points p(*m_grid); p; p.next()) {
+    for (ColumnPoints p(m_active_columns.icy()); p; p.next()) {
       const int i = p.i(), j = p.j();
 
       system.init(i, j, ice_thickness(i, j));
 
       if (system.ks() == 0) {
-        // if no ice, set the entire column to zero age
+        // ice is too thin to resolve: set the entire column to zero age
         m_work.set_column(i, j, 0.0);
       } else {
         // general case: solve advection PDE
@@ -146,7 +153,7 @@ void AgeModel::update(double t, double dt, const AgeModelInputs &inputs) {
         // solve the system for this column; call checks that params set
         system.solve(x);
 
-        // put solution in IceModelVec3
+        // put solution in m_work
         system.fine_to_coarse(x, i, j, m_work);
 
         // Ensure that the age of the ice is non-negative.
@@ -154,7 +161,7 @@ void AgeModel::update(double t, double dt, const AgeModelInputs &inputs) {
         // FIXME: this is a kludge. We need to ensure that our numerical method has the maximum
         // principle instead. (We may still need this for correctness, though.)
         double *column = m_work.get_column(i, j);
-        for (unsigned int k = 0; k < Mz; ++k) {
+        for (unsigned int k = 0; k < m_work.n_levels(i, j); ++k) {
           if (column[k] < 0.0) {
             column[k] = 0.0;
           }
@@ -166,7 +173,7 @@ void AgeModel::update(double t, double dt, const AgeModelInputs &inputs) {
   }
   loop.check();
 
-  m_work.update_ghosts(m_ice_age);
+  m_work.copy_to(m_ice_age, 0.0);
 }
 
 const IceModelVec3 & AgeModel::age() const {
@@ -183,7 +190,9 @@ MaxTimestep AgeModel::max_timestep_impl(double t) const {
                                   " Cannot compute max. time step.");
   }
 
-  return MaxTimestep(m_stress_balance->max_timestep_cfl_3d().dt_max.value(), "age model");
+  MaxTimestep dt = m_stress_balance->max_timestep_cfl_3d().dt_max;
+
+  return MaxTimestep(dt.value(), "age model", dt.i(), dt.j());
 }
 
 void AgeModel::init(const InputOptions &opts) {
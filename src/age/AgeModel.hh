@@ -22,6 +22,8 @@
 
 #include "pism/util/iceModelVec.hh"
 #include "pism/util/Component.hh"
+#include "pism/util/ActiveColumns.hh"
+#include "pism/util/RaggedColumns.hh"
 #include "pism/stressbalance/StressBalance.hh"
 
 namespace pism {
@@ -36,6 +38,8 @@ public:
   void check() const;
 
   const IceModelVec2S *ice_thickness;
+  //! Optional; used to decide when to re-build lists of icy columns.
+  const IceModelVec2CellType *cell_type;
   const IceModelVec3 *u3;
   const IceModelVec3 *v3;
   const IceModelVec3 *w3;
@@ -56,8 +60,10 @@ protected:
   void write_model_state_impl(const File &output) const;
 
   IceModelVec3 m_ice_age;
-  IceModelVec3 m_work;
+  //! New values of age during a time step (levels in the ice only).
+  RaggedColumns m_work;
   stressbalance::StressBalance *m_stress_balance;
+  ActiveColumns m_active_columns;
 };
 
 } // end of namespace pism
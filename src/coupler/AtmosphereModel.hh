@@ -80,6 +80,11 @@ protected:
   virtual void precip_time_series_impl(int i, int j, std::vector<double> &result) const;
   virtual void temp_time_series_impl(int i, int j, std::vector<double> &result) const;
 
+  virtual bool precip_adjustment_impl(std::vector<double> &scale,
+                                      std::vector<double> &shift) const;
+  virtual bool temp_adjustment_impl(std::vector<double> &scale,
+                                    std::vector<double> &shift) const;
+
   virtual DiagnosticList diagnostics_impl() const;
   virtual TSDiagnosticList ts_diagnostics_impl() const;
 protected:
@@ -89,6 +94,24 @@ protected:
 
   static IceModelVec2S::Ptr allocate_temperature(IceGrid::ConstPtr grid);
   static IceModelVec2S::Ptr allocate_precipitation(IceGrid::ConstPtr grid);
+private:
+  //! Point-independent changes of time series made by a chain of modifiers, combined into
+  //! `x -> scale[k] * x + shift[k]`.
+  struct FusedChain {
+    FusedChain();
+    //! the model providing time series modified by the chain
+    const AtmosphereModel *source;
+    //! number of modifiers in the chain
+    unsigned int length;
+    std::vector<double> scale, shift;
+  };
+
+  typedef bool (AtmosphereModel::*Adjustment)(std::vector<double> &scale,
+                                              std::vector<double> &shift) const;
+
+  void fuse(Adjustment adjustment, size_t N, FusedChain &result) const;
+
+  mutable FusedChain m_fused_precip, m_fused_temp;
 };
 
 } // end of namespace atmosphere
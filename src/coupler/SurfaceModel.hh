@@ -109,6 +109,21 @@ protected:
   
   std::shared_ptr<SurfaceModel> m_input_model;
   std::shared_ptr<atmosphere::AtmosphereModel> m_atmosphere;
+private:
+  //! Accumulation, melt, or runoff computed from the SMB when first used after an update.
+  struct DummyOutput {
+    DummyOutput();
+    void request(const IceModelVec2S &smb, IceModelVec2S &result, double sign);
+    void compute();
+
+    //! SMB to use (NULL if there is nothing to compute)
+    const IceModelVec2S *smb;
+    IceModelVec2S *result;
+    //! 1 to use the positive part of the SMB, -1 to use the negative part
+    double sign;
+  };
+
+  mutable DummyOutput m_dummy_accumulation, m_dummy_melt, m_dummy_runoff;
 };
 
 } // end of namespace surface
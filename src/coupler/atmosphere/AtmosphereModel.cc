@@ -84,18 +84,82 @@ void AtmosphereModel::end_pointwise_access() const {
   this->end_pointwise_access_impl();
 }
 
+AtmosphereModel::FusedChain::FusedChain()
+  : source(nullptr), length(0) {
+  // empty
+}
+
 void AtmosphereModel::init_timeseries(const std::vector<double> &ts) const {
   this->init_timeseries_impl(ts);
+
+  fuse(&AtmosphereModel::precip_adjustment_impl, ts.size(), m_fused_precip);
+  fuse(&AtmosphereModel::temp_adjustment_impl, ts.size(), m_fused_temp);
+}
+
+//! Combine point-independent changes of time series made by modifiers at the top of the
+//! chain starting with this model.
+/*!
+ * Stops at the first model that makes point-dependent changes (or is not a modifier).
+ * Time series from this model are then adjusted in one pass instead of a virtual call
+ * and a pass over the time series per modifier.
+ */
+void AtmosphereModel::fuse(Adjustment adjustment, size_t N, FusedChain &result) const {
+  result.length = 0;
+  result.scale.assign(N, 1.0);
+  result.shift.assign(N, 0.0);
+
+  std::vector<double> scale, shift;
+
+  const AtmosphereModel *model = this;
+  while (model->m_input_model) {
+    scale.assign(N, 1.0);
+    shift.assign(N, 0.0);
+
+    if (not (model->*adjustment)(scale, shift)) {
+      break;
+    }
+
+    // "model" is applied *before* all the modifiers above it
+    for (size_t k = 0; k < N; ++k) {
+      result.shift[k] += result.scale[k] * shift[k];
+      result.scale[k] *= scale[k];
+    }
+
+    result.length += 1;
+    model = model->m_input_model.get();
+  }
+
+  result.source = model;
 }
 
 void AtmosphereModel::precip_time_series(int i, int j, std::vector<double> &result) const {
   result.resize(m_ts_times.size());
-  this->precip_time_series_impl(i, j, result);
+
+  const FusedChain &chain = m_fused_precip;
+  if (chain.length > 0) {
+    chain.source->precip_time_series(i, j, result);
+
+    for (size_t k = 0; k < result.size(); ++k) {
+      result[k] = chain.scale[k] * result[k] + chain.shift[k];
+    }
+  } else {
+    this->precip_time_series_impl(i, j, result);
+  }
 }
 
 void AtmosphereModel::temp_time_series(int i, int j, std::vector<double> &result) const {
   result.resize(m_ts_times.size());
-  this->temp_time_series_impl(i, j, result);
+
+  const FusedChain &chain = m_fused_temp;
+  if (chain.length > 0) {
+    chain.source->temp_time_series(i, j, result);
+
+    for (size_t k = 0; k < result.size(); ++k) {
+      result[k] = chain.scale[k] * result[k] + chain.shift[k];
+    }
+  } else {
+    this->temp_time_series_impl(i, j, result);
+  }
 }
 
 namespace diagnostics {
@@ -296,6 +360,36 @@ void AtmosphereModel::precip_time_series_impl(int i, int j, std::vector<double>
   }
 }
 
+//! Point-independent changes of precipitation time series made by a modifier.
+/*!
+ * A modifier that changes precipitation time series by `x -> scale[k] * x + shift[k]` at
+ * all grid points should set `scale` and `shift` (of the length of the time series,
+ * filled with ones and zeros, respectively) and return true. Then these changes may be
+ * applied instead of calling its precip_time_series_impl().
+ *
+ * Modifiers that don't change precipitation time series should return true without
+ * changing `scale` and `shift`.
+ *
+ * Returns false (the default) if precipitation time series are changed in some other way.
+ */
+bool AtmosphereModel::precip_adjustment_impl(std::vector<double> &scale,
+                                             std::vector<double> &shift) const {
+  (void) scale;
+  (void) shift;
+  return false;
+}
+
+//! Point-independent changes of temperature time series made by a modifier.
+/*!
+ * See precip_adjustment_impl().
+ */
+bool AtmosphereModel::temp_adjustment_impl(std::vector<double> &scale,
+                                           std::vector<double> &shift) const {
+  (void) scale;
+  (void) shift;
+  return false;
+}
+
 void AtmosphereModel::init_timeseries_impl(const std::vector<double> &ts) const {
   if (m_input_model) {
     m_input_model->init_timeseries(ts);
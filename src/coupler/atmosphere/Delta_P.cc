@@ -78,5 +78,22 @@ void Delta_P::precip_time_series_impl(int i, int j, std::vector<double> &result)
   }
 }
 
+bool Delta_P::precip_adjustment_impl(std::vector<double> &scale,
+                                     std::vector<double> &shift) const {
+  (void) scale;
+  for (unsigned int k = 0; k < m_offset_values.size(); ++k) {
+    shift[k] = m_offset_values[k];
+  }
+  return true;
+}
+
+bool Delta_P::temp_adjustment_impl(std::vector<double> &scale,
+                                   std::vector<double> &shift) const {
+  (void) scale;
+  (void) shift;
+  // temperature is not modified
+  return true;
+}
+
 } // end of namespace atmosphere
 } // end of namespace pism
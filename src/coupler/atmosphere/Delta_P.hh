@@ -41,6 +41,8 @@ private:
 
   void init_timeseries_impl(const std::vector<double> &ts) const;
   void precip_time_series_impl(int i, int j, std::vector<double> &values) const;
+  bool precip_adjustment_impl(std::vector<double> &scale, std::vector<double> &shift) const;
+  bool temp_adjustment_impl(std::vector<double> &scale, std::vector<double> &shift) const;
 
   mutable std::vector<double> m_offset_values;
 
@@ -76,5 +76,22 @@ void Delta_T::temp_time_series_impl(int i, int j, std::vector<double> &result) c
   }
 }
 
+bool Delta_T::precip_adjustment_impl(std::vector<double> &scale,
+                                     std::vector<double> &shift) const {
+  (void) scale;
+  (void) shift;
+  // precipitation is not modified
+  return true;
+}
+
+bool Delta_T::temp_adjustment_impl(std::vector<double> &scale,
+                                   std::vector<double> &shift) const {
+  (void) scale;
+  for (unsigned int k = 0; k < m_offset_values.size(); ++k) {
+    shift[k] = m_offset_values[k];
+  }
+  return true;
+}
+
 } // end of namespace atmosphere
 } // end of namespace pism
@@ -32,7 +32,9 @@ namespace atmosphere {
 
 ElevationChange::ElevationChange(IceGrid::ConstPtr grid, std::shared_ptr<AtmosphereModel> in)
   : AtmosphereModel(grid, in),
-  m_surface(grid, "ice_surface_elevation", WITHOUT_GHOSTS) {
+  m_surface(grid, "ice_surface_elevation", WITHOUT_GHOSTS),
+  m_elevation_change(grid,
+                     m_config->get_number("atmosphere.elevation_change.surface_elevation_tolerance")) {
 
   m_precip_lapse_rate = m_config->get_number("atmosphere.elevation_change.precipitation.lapse_rate",
                                              "(kg m-2 / s) / m");
@@ -47,6 +49,10 @@ ElevationChange::ElevationChange(IceGrid::ConstPtr grid, std::shared_ptr<Atmosph
     m_precip_method = method == "scale" ? SCALE : SHIFT;
   }
 
+  if (m_precip_method == SCALE) {
+    m_elevation_change.enable_scaling(m_temp_lapse_rate, m_precip_exp_factor);
+  }
+
   {
     ForcingOptions opt(*m_grid->ctx(), "atmosphere.elevation_change");
 
@@ -114,12 +120,14 @@ void ElevationChange::update_impl(const Geometry &geometry, double t, double dt)
   // temperature and precipitation time series
   m_surface.copy_from(geometry.ice_surface_elevation);
 
+  // re-computes elevation changes only where necessary (see ElevationChangeCache)
+  m_elevation_change.update(m_surface, *m_reference_surface);
+
   // temperature
   {
     m_temperature->copy_from(m_input_model->mean_annual_temp());
 
-    lapse_rate_correction(m_surface, *m_reference_surface,
-                          m_temp_lapse_rate, *m_temperature);
+    m_elevation_change.shift(m_temp_lapse_rate, *m_temperature);
   }
 
   // precipitation
@@ -128,29 +136,11 @@ void ElevationChange::update_impl(const Geometry &geometry, double t, double dt)
 
     switch (m_precip_method) {
     case SCALE:
-      {
-        const IceModelVec2S &input_temperature = m_input_model->mean_annual_temp();
-
-        IceModelVec::AccessList list{m_temperature.get(),
-                                     &input_temperature,
-                                     m_precipitation.get()};
-
-        for (Points p(*m_grid); p; p.next()) {
-          const int i = p.i(), j = p.j();
-
-          double dT = (*m_temperature)(i, j) - input_temperature(i, j);
-
-          (*m_precipitation)(i, j) *= std::exp(m_precip_exp_factor * dT);
-        }
-
-      }
+      m_elevation_change.scale(*m_precipitation);
       break;
     case SHIFT:
     default:
-      {
-        lapse_rate_correction(m_surface, *m_reference_surface,
-                              m_precip_lapse_rate, *m_precipitation);
-      }
+      m_elevation_change.shift(m_precip_lapse_rate, *m_precipitation);
       break;
     }
   }
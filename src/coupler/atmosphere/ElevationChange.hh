@@ -22,6 +22,7 @@
 #include "pism/coupler/AtmosphereModel.hh"
 
 #include "pism/util/iceModelVec2T.hh"
+#include "pism/coupler/util/lapse_rates.hh"
 
 namespace pism {
 namespace atmosphere {
@@ -59,6 +60,8 @@ protected:
   IceModelVec2S::Ptr m_precipitation;
   IceModelVec2S::Ptr m_temperature;
   IceModelVec2S m_surface;
+
+  ElevationChangeCache m_elevation_change;
 };
 
 } // end of namespace atmosphere
@@ -41,6 +41,8 @@ private:
   const IceModelVec2S& mean_precipitation_impl() const;
 
   void precip_time_series_impl(int i, int j, std::vector<double> &values) const;
+  bool precip_adjustment_impl(std::vector<double> &scale, std::vector<double> &shift) const;
+  bool temp_adjustment_impl(std::vector<double> &scale, std::vector<double> &shift) const;
 
   mutable std::vector<double> m_offset_values;
 
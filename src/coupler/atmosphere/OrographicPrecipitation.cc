@@ -18,7 +18,7 @@
 
 #include "OrographicPrecipitation.hh"
 
-#include "OrographicPrecipitationSerial.hh"
+#include "OrographicPrecipitationParallel.hh"
 #include "pism/coupler/util/options.hh"
 #include "pism/geometry/Geometry.hh"
 #include "pism/util/ConfigInterface.hh"
@@ -34,7 +34,10 @@ OrographicPrecipitation::OrographicPrecipitation(IceGrid::ConstPtr grid,
 
   m_precipitation = allocate_precipitation(grid);
 
-  m_work0 = m_precipitation->allocate_proc0_copy();
+  {
+    PetscErrorCode ierr = DMCreateGlobalVector(*m_precipitation->dm(), m_surface.rawptr());
+    PISM_CHK(ierr, "DMCreateGlobalVector");
+  }
 
   const int
     Mx = m_grid->Mx(),
@@ -43,18 +46,11 @@ OrographicPrecipitation::OrographicPrecipitation(IceGrid::ConstPtr grid,
     Nx = Z * (Mx - 1) + 1,
     Ny = Z * (My - 1) + 1;
 
-  ParallelSection rank0(m_grid->com);
-  try {
-    if (m_grid->rank() == 0) {
-      m_serial_model.reset(new OrographicPrecipitationSerial(*m_config,
-                                                             Mx, My,
-                                                             m_grid->dx(), m_grid->dy(),
-                                                             Nx, Ny));
-    }
-  } catch (...) {
-    rank0.failed();
-  }
-  rank0.check();
+  m_model.reset(new OrographicPrecipitationParallel(m_grid->com, *m_config,
+                                                    m_precipitation->dm(),
+                                                    Mx, My,
+                                                    m_grid->dx(), m_grid->dy(),
+                                                    Nx, Ny));
 }
 
 OrographicPrecipitation::~OrographicPrecipitation() {
@@ -83,22 +79,10 @@ void OrographicPrecipitation::init_impl(const Geometry &geometry) {
 void OrographicPrecipitation::update_impl(const Geometry &geometry, double t, double dt) {
   m_input_model->update(geometry, t, dt);
 
-  geometry.ice_surface_elevation.put_on_proc0(*m_work0);
-
-  ParallelSection rank0(m_grid->com);
-  try {
-    if (m_grid->rank() == 0) { // processor zero updates the precipitation
-      m_serial_model->update(*m_work0);
-
-      PetscErrorCode ierr = VecCopy(m_serial_model->precipitation(), *m_work0);
-      PISM_CHK(ierr, "VecCopy");
-    }
-  } catch (...) {
-    rank0.failed();
-  }
-  rank0.check();
+  geometry.ice_surface_elevation.copy_to_vec(m_precipitation->dm(), m_surface);
 
-  m_precipitation->get_from_proc0(*m_work0);
+  m_model->update(m_surface, m_precipitation->vec());
+  m_precipitation->inc_state_counter();
 
   // convert from mm/s to kg / (m^2 s):
   double water_density = m_config->get_number("constants.fresh_water.density");
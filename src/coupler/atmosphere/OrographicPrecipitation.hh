@@ -27,7 +27,7 @@ class Geometry;
 
 namespace atmosphere {
 
-class OrographicPrecipitationSerial;
+class OrographicPrecipitationParallel;
 
 class OrographicPrecipitation : public AtmosphereModel {
 public:
@@ -50,12 +50,12 @@ protected:
 
   IceModelVec2S::Ptr m_precipitation;
 
-  //! Storage on rank zero. Used to pass the load to the serial orographic precipitation
-  //! Model.
-  petsc::Vec::Ptr m_work0;
+  //! Surface elevation (without ghosts). Used to pass it to the orographic precipitation
+  //! model.
+  petsc::Vec m_surface;
 
-  //! Serial orographic precipitation model.
-  std::unique_ptr<OrographicPrecipitationSerial> m_serial_model;
+  //! Orographic precipitation model (distributed among all processes).
+  std::unique_ptr<OrographicPrecipitationParallel> m_model;
 };
 
 } // end of namespace atmosphere
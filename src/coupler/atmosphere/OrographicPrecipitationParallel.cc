@@ -0,0 +1,471 @@
+// Copyright (C) 2018, 2019, 2020 Andy Aschwanden and Constantine Khroulev
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 3 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "OrographicPrecipitationParallel.hh"
+
+#include <algorithm>      // std::max, std::min, std::fill
+#include <cassert>
+#include <cmath>          // sin, cos, fabs
+#include <gsl/gsl_math.h> // M_PI
+#include <petscdmda.h>    // DMDAGetAO
+
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/petscwrappers/IS.hh"
+#include "pism/util/pism_utilities.hh"
+#include "pism/util/fftw_utilities.hh"
+
+namespace pism {
+namespace atmosphere {
+
+//! Distribute `N` items among `size` processes (in contiguous blocks).
+static void block_distribution(int N, int size, std::vector<int> &start, std::vector<int> &count) {
+  start.resize(size);
+  count.resize(size);
+
+  int offset = 0;
+  for (int r = 0; r < size; ++r) {
+    count[r] = N / size + (r < N % size ? 1 : 0);
+    start[r] = offset;
+    offset += count[r];
+  }
+}
+
+//! Compute displacements given counts.
+static std::vector<int> displacements(const std::vector<int> &counts) {
+  std::vector<int> result(counts.size(), 0);
+  for (unsigned int k = 1; k < counts.size(); ++k) {
+    result[k] = result[k - 1] + counts[k - 1];
+  }
+  return result;
+}
+
+//! Create a plan computing `howmany` in-place 1D transforms of length `n` stored
+//! contiguously in `data`.
+static fftw_plan plan_many(int n, int howmany, fftw_complex *data, int sign) {
+  if (howmany == 0) {
+    return NULL;
+  }
+  return fftw_plan_many_dft(1, &n, howmany,
+                            data, NULL, 1, n,
+                            data, NULL, 1, n,
+                            sign, FFTW_ESTIMATE);
+}
+
+static void execute(fftw_plan plan) {
+  if (plan != NULL) {
+    fftw_execute(plan);
+  }
+}
+
+/*!
+ * @param[in] com MPI communicator
+ * @param[in] config configuration database
+ * @param[in] dm DMDA used by inputs and outputs of update()
+ * @param[in] Mx grid size in the X direction
+ * @param[in] My grid size in the Y direction
+ * @param[in] dx grid spacing in the X direction
+ * @param[in] dy grid spacing in the Y direction
+ * @param[in] Nx extended grid size in the X direction
+ * @param[in] Ny extended grid size in the Y direction
+ */
+OrographicPrecipitationParallel::OrographicPrecipitationParallel(MPI_Comm com,
+                                                                 const Config &config,
+                                                                 petsc::DM::Ptr dm,
+                                                                 int Mx, int My,
+                                                                 double dx, double dy,
+                                                                 int Nx, int Ny)
+  : m_com(com), m_Mx(Mx), m_My(My), m_Nx(Nx), m_Ny(Ny),
+    m_rows(NULL), m_columns(NULL),
+    m_row_forward(NULL), m_row_inverse(NULL),
+    m_column_forward(NULL), m_column_inverse(NULL) {
+
+  m_i0_offset = (Nx - Mx) / 2;
+  m_j0_offset = (Ny - My) / 2;
+
+  m_background_precip_pre  = config.get_number("atmosphere.orographic_precipitation.background_precip_pre", "mm/s");
+  m_background_precip_post = config.get_number("atmosphere.orographic_precipitation.background_precip_post", "mm/s");
+  m_precip_scale_factor    = config.get_number("atmosphere.orographic_precipitation.scale_factor");
+  m_truncate               = config.get_flag("atmosphere.orographic_precipitation.truncate");
+
+  int rank = 0, size = 1;
+  MPI_Comm_rank(m_com, &rank);
+  MPI_Comm_size(m_com, &size);
+
+  // domain decomposition of the extended grid
+  {
+    block_distribution(m_Ny, size, m_row_start, m_row_count);
+    block_distribution(m_Nx, size, m_column_start, m_column_count);
+
+    m_n_rows    = m_row_count[rank];
+    m_n_columns = m_column_count[rank];
+
+    // counts of doubles (each complex number is a pair of doubles)
+    m_row_block_counts.resize(size);
+    m_column_block_counts.resize(size);
+    for (int r = 0; r < size; ++r) {
+      // a block of owned rows sent to (received from) rank r
+      m_row_block_counts[r] = 2 * m_n_rows * m_column_count[r];
+      // a block of owned columns sent to (received from) rank r
+      m_column_block_counts[r] = 2 * m_row_count[r] * m_n_columns;
+    }
+    m_row_block_displs    = displacements(m_row_block_counts);
+    m_column_block_displs = displacements(m_column_block_counts);
+  }
+
+  // the scatter moving rows of the physical grid to (and from) processes owning
+  // corresponding rows of the extended grid
+  {
+    PetscErrorCode ierr = 0;
+
+    int
+      first = std::max(m_row_start[rank] - m_j0_offset, 0),
+      last  = std::min(m_row_start[rank] + m_n_rows - m_j0_offset, m_My);
+
+    m_slab_row_start = first;
+
+    int n_local = std::max(last - first, 0) * m_Mx;
+
+    ierr = VecCreateMPI(m_com, n_local, PETSC_DETERMINE, m_slab.rawptr());
+    PISM_CHK(ierr, "VecCreateMPI");
+
+    // Rows are assigned to processes in order, so the ownership range of m_slab matches
+    // the part of the natural ordering owned by this process.
+    PetscInt start = 0, end = 0;
+    ierr = VecGetOwnershipRange(m_slab, &start, &end);
+    PISM_CHK(ierr, "VecGetOwnershipRange");
+    assert(n_local == 0 or start == first * m_Mx);
+
+    // convert natural indexes into PETSc indexes used by the DMDA
+    std::vector<PetscInt> indexes(n_local);
+    for (int k = 0; k < n_local; ++k) {
+      indexes[k] = start + k;
+    }
+
+    AO ao = NULL;
+    ierr = DMDAGetAO(*dm, &ao);
+    PISM_CHK(ierr, "DMDAGetAO");
+
+    ierr = AOApplicationToPetsc(ao, n_local, indexes.data());
+    PISM_CHK(ierr, "AOApplicationToPetsc");
+
+    petsc::IS from, to;
+    ierr = ISCreateGeneral(PETSC_COMM_SELF, n_local, indexes.data(), PETSC_COPY_VALUES,
+                           from.rawptr());
+    PISM_CHK(ierr, "ISCreateGeneral");
+
+    ierr = ISCreateStride(PETSC_COMM_SELF, n_local, start, 1, to.rawptr());
+    PISM_CHK(ierr, "ISCreateStride");
+
+    petsc::Vec tmp;
+    ierr = DMCreateGlobalVector(*dm, tmp.rawptr());
+    PISM_CHK(ierr, "DMCreateGlobalVector");
+
+    ierr = VecScatterCreate(tmp, from, m_slab, to, m_scatter.rawptr());
+    PISM_CHK(ierr, "VecScatterCreate");
+  }
+
+  // memory allocation
+  {
+    // allocate at least one element to get a valid pointer on processes that do not own
+    // any rows or columns
+    m_rows    = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * std::max(m_n_rows * m_Nx, 1));
+    m_columns = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * std::max(m_n_columns * m_Ny, 1));
+
+    m_send.resize(std::max(m_n_rows * m_Nx, m_n_columns * m_Ny));
+    m_receive.resize(m_send.size());
+
+    // 1D transforms of owned rows and columns
+    m_row_forward    = plan_many(m_Nx, m_n_rows, m_rows, FFTW_FORWARD);
+    m_row_inverse    = plan_many(m_Nx, m_n_rows, m_rows, FFTW_BACKWARD);
+    m_column_forward = plan_many(m_Ny, m_n_columns, m_columns, FFTW_FORWARD);
+    m_column_inverse = plan_many(m_Ny, m_n_columns, m_columns, FFTW_BACKWARD);
+
+    // Note: FFTW is weird. If a malloc() call fails it will just call
+    // abort() on you without giving you a chance to recover or tell the
+    // user what happened. This is why we don't check return values of
+    // fftw_malloc() and fftw_plan_many_dft() calls here...
+    //
+    // (Constantine Khroulev, February 1, 2015)
+  }
+
+  compute_transfer_function(config, dx, dy);
+}
+
+OrographicPrecipitationParallel::~OrographicPrecipitationParallel() {
+  for (auto plan : {m_row_forward, m_row_inverse, m_column_forward, m_column_inverse}) {
+    if (plan != NULL) {
+      fftw_destroy_plan(plan);
+    }
+  }
+  fftw_free(m_rows);
+  fftw_free(m_columns);
+}
+
+/*!
+ * Compute the transfer function relating Fourier transforms of the surface elevation and
+ * of the precipitation in owned columns of the extended grid.
+ *
+ * Solves:
+ *
+ * Phat(k,l) = (Cw * i * sigma * Hhat(k,l)) /
+ *             (1 - i * m * Hw) * (1 + i * sigma * tauc) * (1 + i * sigma * tauc);
+ *
+ * see equation (49) in
+ *
+ * R. B. Smith and I. Barstad, 2004:
+ * A Linear Theory of Orographic Precipitation. J. Atmos. Sci. 61, 1377-1391.
+ */
+void OrographicPrecipitationParallel::compute_transfer_function(const Config &config,
+                                                                double dx, double dy) {
+  // regularization
+  const double eps = 1.0e-18;
+
+  const double
+    tau_c          = config.get_number("atmosphere.orographic_precipitation.conversion_time"),
+    tau_f          = config.get_number("atmosphere.orographic_precipitation.fallout_time"),
+    Hw             = config.get_number("atmosphere.orographic_precipitation.water_vapor_scale_height"),
+    Nm             = config.get_number("atmosphere.orographic_precipitation.moist_stability_frequency"),
+    wind_speed     = config.get_number("atmosphere.orographic_precipitation.wind_speed"),
+    wind_direction = config.get_number("atmosphere.orographic_precipitation.wind_direction"),
+    gamma          = config.get_number("atmosphere.orographic_precipitation.lapse_rate"),
+    Theta_m        = config.get_number("atmosphere.orographic_precipitation.moist_adiabatic_lapse_rate"),
+    rho_Sref       = config.get_number("atmosphere.orographic_precipitation.reference_density"),
+    latitude       = config.get_number("atmosphere.orographic_precipitation.coriolis_latitude");
+
+  // derived constants
+  const double
+    f  = 2.0 * 7.2921e-5 * sin(latitude * M_PI / 180.0),
+    u  = -sin(wind_direction * 2.0 * M_PI / 360.0) * wind_speed,
+    v  = -cos(wind_direction * 2.0 * M_PI / 360.0) * wind_speed,
+    Cw = rho_Sref * Theta_m / gamma;
+
+  std::vector<double>
+    kx = fftfreq(m_Nx, dx / (2.0 * M_PI)),
+    ky = fftfreq(m_Ny, dy / (2.0 * M_PI));
+
+  std::complex<double> I(0.0, 1.0);
+
+  int rank = 0;
+  MPI_Comm_rank(m_com, &rank);
+
+  m_transfer.resize(m_n_columns * m_Ny);
+
+  for (int c = 0; c < m_n_columns; c++) {
+    const int i = m_column_start[rank] + c;
+    for (int j = 0; j < m_Ny; j++) {
+
+      double sigma = u * kx[i] + v * ky[j];
+
+      // See equation (6) in [@ref SmithBarstadBonneau2005]
+      std::complex<double> m;
+      {
+        double denominator = sigma * sigma - f * f;
+
+        // avoid dividing by zero:
+        if (fabs(denominator) < eps) {
+          denominator = denominator >= 0 ? eps : -eps;
+        }
+
+        double m_squared = (Nm * Nm - sigma * sigma) * (kx[i] * kx[i] + ky[j] * ky[j]) / denominator;
+
+        // Note: this is a *complex* square root.
+        m = std::sqrt(std::complex<double>(m_squared));
+
+        if (m_squared >= 0.0 and sigma != 0.0) {
+          m *= sigma > 0.0 ? 1.0 : -1.0;
+        }
+      }
+
+      // avoid dividing by zero:
+      double delta = 0.0;
+      if (std::abs(1.0 - I * m * Hw) < eps) {
+        delta = eps;
+      }
+
+      // See equation (49) in [@ref SmithBarstad2004] or equation (3) in [@ref
+      // SmithBarstadBonneau2005].
+      m_transfer[c * m_Ny + j] = (Cw * I * sigma /
+                                  ((1.0 - I * m * Hw + delta) *
+                                   (1.0 + I * sigma * tau_c) *
+                                   (1.0 + I * sigma * tau_f)));
+      // Note: sigma, tau_c, and tau_f are purely real, so the second and the third
+      // factors in the denominator are never zero.
+      //
+      // The first factor (1 - i m H_w) *could* be zero. Here we check if it is and
+      // "regularize" if necessary.
+    }
+  }
+}
+
+//! Send blocks of owned rows to processes owning corresponding columns.
+void OrographicPrecipitationParallel::rows_to_columns() {
+  auto *rows    = reinterpret_cast<std::complex<double>*>(m_rows);
+  auto *columns = reinterpret_cast<std::complex<double>*>(m_columns);
+
+  const int size = m_row_start.size();
+
+  int k = 0;
+  for (int r = 0; r < size; ++r) {
+    for (int j = 0; j < m_n_rows; ++j) {
+      for (int i = m_column_start[r]; i < m_column_start[r] + m_column_count[r]; ++i) {
+        m_send[k++] = rows[j * m_Nx + i];
+      }
+    }
+  }
+
+  int err = MPI_Alltoallv(m_send.data(), m_row_block_counts.data(), m_row_block_displs.data(), MPI_DOUBLE,
+                          m_receive.data(), m_column_block_counts.data(), m_column_block_displs.data(), MPI_DOUBLE,
+                          m_com);
+  PISM_C_CHK(err, MPI_SUCCESS, "MPI_Alltoallv");
+
+  k = 0;
+  for (int r = 0; r < size; ++r) {
+    for (int j = m_row_start[r]; j < m_row_start[r] + m_row_count[r]; ++j) {
+      for (int c = 0; c < m_n_columns; ++c) {
+        columns[c * m_Ny + j] = m_receive[k++];
+      }
+    }
+  }
+}
+
+//! Send blocks of owned columns to processes owning corresponding rows.
+void OrographicPrecipitationParallel::columns_to_rows() {
+  auto *rows    = reinterpret_cast<std::complex<double>*>(m_rows);
+  auto *columns = reinterpret_cast<std::complex<double>*>(m_columns);
+
+  const int size = m_row_start.size();
+
+  int k = 0;
+  for (int r = 0; r < size; ++r) {
+    for (int j = m_row_start[r]; j < m_row_start[r] + m_row_count[r]; ++j) {
+      for (int c = 0; c < m_n_columns; ++c) {
+        m_send[k++] = columns[c * m_Ny + j];
+      }
+    }
+  }
+
+  int err = MPI_Alltoallv(m_send.data(), m_column_block_counts.data(), m_column_block_displs.data(), MPI_DOUBLE,
+                          m_receive.data(), m_row_block_counts.data(), m_row_block_displs.data(), MPI_DOUBLE,
+                          m_com);
+  PISM_C_CHK(err, MPI_SUCCESS, "MPI_Alltoallv");
+
+  k = 0;
+  for (int r = 0; r < size; ++r) {
+    for (int j = 0; j < m_n_rows; ++j) {
+      for (int i = m_column_start[r]; i < m_column_start[r] + m_column_count[r]; ++i) {
+        rows[j * m_Nx + i] = m_receive[k++];
+      }
+    }
+  }
+}
+
+/*!
+ * Update precipitation.
+ *
+ * @param[in] surface_elevation surface elevation (a global Vec of the DMDA `dm`)
+ * @param[out] precipitation precipitation, in mm/s (a global Vec of the DMDA `dm`)
+ */
+void OrographicPrecipitationParallel::update(Vec surface_elevation, Vec precipitation) {
+  PetscErrorCode ierr = 0;
+
+  auto *rows    = reinterpret_cast<std::complex<double>*>(m_rows);
+  auto *columns = reinterpret_cast<std::complex<double>*>(m_columns);
+
+  // get owned rows of the surface elevation
+  ierr = VecScatterBegin(m_scatter, surface_elevation, m_slab, INSERT_VALUES, SCATTER_FORWARD);
+  PISM_CHK(ierr, "VecScatterBegin");
+
+  ierr = VecScatterEnd(m_scatter, surface_elevation, m_slab, INSERT_VALUES, SCATTER_FORWARD);
+  PISM_CHK(ierr, "VecScatterEnd");
+
+  int rank = 0;
+  MPI_Comm_rank(m_com, &rank);
+
+  // index of the first owned row of the extended grid relative to the physical grid
+  const int row_offset = m_row_start[rank] - m_j0_offset;
+
+  PetscInt n_local = 0;
+  ierr = VecGetLocalSize(m_slab, &n_local);
+  PISM_CHK(ierr, "VecGetLocalSize");
+  const int n_slab_rows = n_local / m_Mx;
+
+  // Compute fft2(surface_elevation)
+  {
+    std::fill(rows, rows + m_n_rows * m_Nx, 0.0);
+
+    {
+      petsc::VecArray slab(m_slab);
+      const double *h = slab.get();
+
+      for (int s = 0; s < n_slab_rows; ++s) {
+        const int j = m_slab_row_start + s - row_offset;
+        for (int i = 0; i < m_Mx; ++i) {
+          rows[j * m_Nx + m_i0_offset + i] = h[s * m_Mx + i];
+        }
+      }
+    }
+
+    execute(m_row_forward);
+    rows_to_columns();
+    execute(m_column_forward);
+  }
+
+  for (int k = 0; k < m_n_columns * m_Ny; ++k) {
+    columns[k] *= m_transfer[k];
+  }
+
+  // Compute ifft2(P_hat)
+  {
+    execute(m_column_inverse);
+    columns_to_rows();
+    execute(m_row_inverse);
+  }
+
+  {
+    petsc::VecArray slab(m_slab);
+    double *p = slab.get();
+
+    const double normalization = 1.0 / (m_Nx * m_Ny);
+
+    for (int s = 0; s < n_slab_rows; ++s) {
+      const int j = m_slab_row_start + s - row_offset;
+      for (int i = 0; i < m_Mx; ++i) {
+        double P = rows[j * m_Nx + m_i0_offset + i].real() * normalization;
+
+        P += m_background_precip_pre;
+        if (m_truncate) {
+          P = std::max(P, 0.0);
+        }
+        P *= m_precip_scale_factor;
+        P += m_background_precip_post;
+
+        p[s * m_Mx + i] = P;
+      }
+    }
+  }
+
+  ierr = VecScatterBegin(m_scatter, m_slab, precipitation, INSERT_VALUES, SCATTER_REVERSE);
+  PISM_CHK(ierr, "VecScatterBegin");
+
+  ierr = VecScatterEnd(m_scatter, m_slab, precipitation, INSERT_VALUES, SCATTER_REVERSE);
+  PISM_CHK(ierr, "VecScatterEnd");
+}
+
+} // end of namespace atmosphere
+} // end of namespace pism
@@ -0,0 +1,128 @@
+// Copyright (C) 2018, 2020 Constantine Khroulev and Andy Aschwanden
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 3 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef OROGRAPHICPRECIPITATIONPARALLEL_H
+#define OROGRAPHICPRECIPITATIONPARALLEL_H
+
+#include <vector>
+#include <complex>
+
+#include <mpi.h>
+#include <fftw3.h>
+#include <petscvec.h>
+
+#include "pism/util/petscwrappers/DM.hh"
+#include "pism/util/petscwrappers/Vec.hh"
+#include "pism/util/petscwrappers/VecScatter.hh"
+
+namespace pism {
+
+class Config;
+
+namespace atmosphere {
+
+//! Class implementing the linear model of orographic precipitation [@ref
+//! SmithBarstad2004], [@ref SmithBarstadBonneau2005].
+/*!
+ * Uses all processes of the communicator `com` to compute 2D FFTs on the extended grid.
+ *
+ * The extended grid is distributed in two ways: by rows (the first and the last step of
+ * the computation: 1D transforms in the X direction) and by columns (1D transforms in the
+ * Y direction and the application of the transfer function). Data are moved between the
+ * two using MPI_Alltoallv().
+ *
+ * The transfer function depends on the grid and on model parameters (wind speed and
+ * direction, etc) only, so it is computed once, in the constructor.
+ */
+class OrographicPrecipitationParallel {
+public:
+  OrographicPrecipitationParallel(MPI_Comm com,
+                                  const Config &config,
+                                  petsc::DM::Ptr dm,
+                                  int Mx, int My,
+                                  double dx, double dy,
+                                  int Nx, int Ny);
+  ~OrographicPrecipitationParallel();
+
+  void update(Vec surface_elevation, Vec precipitation);
+
+private:
+  void compute_transfer_function(const Config &config, double dx, double dy);
+
+  void rows_to_columns();
+  void columns_to_rows();
+
+  MPI_Comm m_com;
+
+  //! truncate
+  bool m_truncate;
+  //! precipitation scale factor
+  double m_precip_scale_factor;
+  //! background precipitation
+  double m_background_precip_pre, m_background_precip_post;
+
+  // grid size
+  int m_Mx;
+  int m_My;
+
+  // extended grid size
+  int m_Nx;
+  int m_Ny;
+
+  // indices into extended grid for the corner of the physical grid
+  int m_i0_offset;
+  int m_j0_offset;
+
+  //! rows of the extended grid owned by each process
+  std::vector<int> m_row_start, m_row_count;
+  //! columns of the extended grid owned by each process
+  std::vector<int> m_column_start, m_column_count;
+
+  //! number of rows and columns owned by this process
+  int m_n_rows, m_n_columns;
+
+  //! Alltoallv() counts and displacements (in doubles) for blocks of rows and columns
+  std::vector<int> m_row_block_counts, m_row_block_displs;
+  std::vector<int> m_column_block_counts, m_column_block_displs;
+
+  //! rows of the physical grid owned by this process (in the natural ordering)
+  petsc::Vec m_slab;
+  //! first physical row in m_slab
+  int m_slab_row_start;
+  //! scatter from a DMDA Vec to m_slab
+  petsc::VecScatter m_scatter;
+
+  //! transfer function (owned columns, "column-major")
+  std::vector<std::complex<double> > m_transfer;
+
+  //! owned rows of the extended grid ("row-major")
+  fftw_complex *m_rows;
+  //! owned columns of the extended grid ("column-major")
+  fftw_complex *m_columns;
+
+  //! Alltoallv() buffers
+  std::vector<std::complex<double> > m_send, m_receive;
+
+  fftw_plan m_row_forward, m_row_inverse;
+  fftw_plan m_column_forward, m_column_inverse;
+};
+
+} // end of namespace atmosphere
+} // end of namespace pism
+
+#endif /* OROGRAPHICPRECIPITATIONPARALLEL_H */
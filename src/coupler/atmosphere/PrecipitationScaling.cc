@@ -83,5 +83,22 @@ void PrecipitationScaling::precip_time_series_impl(int i, int j, std::vector<dou
   }
 }
 
+bool PrecipitationScaling::precip_adjustment_impl(std::vector<double> &scale,
+                                                  std::vector<double> &shift) const {
+  (void) shift;
+  for (unsigned int k = 0; k < m_scaling_values.size(); ++k) {
+    scale[k] = m_scaling_values[k];
+  }
+  return true;
+}
+
+bool PrecipitationScaling::temp_adjustment_impl(std::vector<double> &scale,
+                                                std::vector<double> &shift) const {
+  (void) scale;
+  (void) shift;
+  // temperature is not modified
+  return true;
+}
+
 } // end of namespace atmosphere
 } // end of namespace pism
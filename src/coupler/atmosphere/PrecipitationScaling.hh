@@ -68,6 +68,8 @@ protected:
   const IceModelVec2S& mean_precipitation_impl() const;
 
   void precip_time_series_impl(int i, int j, std::vector<double> &values) const;
+  bool precip_adjustment_impl(std::vector<double> &scale, std::vector<double> &shift) const;
+  bool temp_adjustment_impl(std::vector<double> &scale, std::vector<double> &shift) const;
 
 protected:
   double m_exp_factor;
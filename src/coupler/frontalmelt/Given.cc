@@ -30,9 +30,11 @@ namespace frontalmelt {
 Given::Given(IceGrid::ConstPtr g)
   : FrontalMelt(g, nullptr) {
 
-  m_frontal_melt_rate.reset(new IceModelVec2T(g, "frontal_melt_rate", 1, 1));
+  m_forcing.reset(new IceModelVec2T(g, "frontal_melt_rate", 1, 1));
 
-  m_frontal_melt_rate->init_constant(0.0);
+  m_forcing->init_constant(0.0);
+
+  m_frontal_melt_rate = allocate_frontal_melt_rate(g);
 }
 
 Given::~Given() {
@@ -55,41 +57,42 @@ void Given::init_impl(const Geometry &geometry) {
 
     File file(m_grid->com, opt.filename, PISM_NETCDF3, PISM_READONLY);
 
-    m_frontal_melt_rate = IceModelVec2T::ForcingField(m_grid,
-                                                      file,
-                                                      "frontal_melt_rate",
-                                                      "", // no standard name
-                                                      buffer_size,
-                                                      evaluations_per_year,
-                                                      periodic);
+    m_forcing = IceModelVec2T::ForcingField(m_grid,
+                                            file,
+                                            "frontal_melt_rate",
+                                            "", // no standard name
+                                            buffer_size,
+                                            evaluations_per_year,
+                                            periodic);
   }
 
-  m_frontal_melt_rate->set_attrs("climate_forcing", "frontal melt rate",
-                                 "m s-1", "m year-1", "", 0);
+  m_forcing->set_attrs("climate_forcing", "frontal melt rate",
+                       "m s-1", "m year-1", "", 0);
 
-  m_frontal_melt_rate->init(opt.filename, opt.period, opt.reference_time);
+  m_forcing->init(opt.filename, opt.period, opt.reference_time);
 }
 
 void Given::update_impl(const FrontalMeltInputs &inputs, double t, double dt) {
 
   const IceModelVec2CellType &cell_type = inputs.geometry->cell_type;
 
-  // fill m_frontal_melt_rate with values read from an file
-  m_frontal_melt_rate->update(t, dt);
-  m_frontal_melt_rate->average(t, dt);
+  // fill m_forcing with values read from an file
+  m_forcing->update(t, dt);
+  m_forcing->average(t, dt);
 
   // post-processing: keep values at grounded (or grounded and floating) margins and in
   // the interior, filling the rest with zeros
+  //
+  // Note: m_forcing is not modified here. It may keep its values from one time step to the
+  // next (see IceModelVec2T::average()) while the ice front moves.
 
-  IceModelVec::AccessList list{&cell_type, m_frontal_melt_rate.get()};
+  IceModelVec::AccessList list{&cell_type, m_forcing.get(), m_frontal_melt_rate.get()};
 
   for (Points p(*m_grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
-    auto R = (*m_frontal_melt_rate)(i, j);
-
     if (apply(cell_type, i, j)) {
-      (*m_frontal_melt_rate)(i, j) = R;
+      (*m_frontal_melt_rate)(i, j) = (*m_forcing)(i, j);
     } else {
       (*m_frontal_melt_rate)(i, j) = 0.0;
     }
@@ -98,7 +101,7 @@ void Given::update_impl(const FrontalMeltInputs &inputs, double t, double dt) {
 
 MaxTimestep Given::max_timestep_impl(double t) const {
 
-  auto dt = m_frontal_melt_rate->max_timestep(t);
+  auto dt = m_forcing->max_timestep(t);
 
   if (dt.finite()) {
     return MaxTimestep(dt.value(), "frontal_melt given");
@@ -41,7 +41,11 @@ private:
 
   const IceModelVec2S& frontal_melt_rate_impl() const;
 
-  IceModelVec2T::Ptr m_frontal_melt_rate;
+  //! frontal melt rate read from a file
+  IceModelVec2T::Ptr m_forcing;
+
+  //! frontal melt rate at the ice front (zero elsewhere)
+  IceModelVec2S::Ptr m_frontal_melt_rate;
 };
 
 } // end of namespace frontalmelt
@@ -135,28 +135,37 @@ void GivenTH::update_impl(const Geometry &geometry, double t, double dt) {
   IceModelVec2S &temperature = *m_shelf_base_temperature;
   IceModelVec2S &mass_flux = *m_shelf_base_mass_flux;
 
+  // Away from ice shelves outputs of this model are not used: set them to the melting
+  // point temperature of fresh water and zero mass flux.
+  temperature.set(m_config->get_number("constants.fresh_water.melting_point_temperature"));
+  mass_flux.set(0.0);
+
+  m_shelf_cells.update(*m_grid, geometry.cell_type);
+
   IceModelVec::AccessList list{ &ice_thickness, m_theta_ocean.get(), m_salinity_ocean.get(),
       &temperature, &mass_flux};
 
-  for (Points p(*m_grid); p; p.next()) {
-    const int i = p.i(), j = p.j();
+  for (const auto *cells : {&m_shelf_cells.floating(), &m_shelf_cells.halo()}) {
+    for (const auto &cell : *cells) {
+      const int i = cell.i, j = cell.j;
 
-    double potential_temperature_celsius = (*m_theta_ocean)(i,j) - 273.15;
+      double potential_temperature_celsius = (*m_theta_ocean)(i,j) - 273.15;
 
-    double
-      shelf_base_temp_celsius = 0.0,
-      shelf_base_massflux     = 0.0;
+      double
+        shelf_base_temp_celsius = 0.0,
+        shelf_base_massflux     = 0.0;
 
-    pointwise_update(c,
-                     (*m_salinity_ocean)(i,j),
-                     potential_temperature_celsius,
-                     ice_thickness(i,j),
-                     &shelf_base_temp_celsius,
-                     &shelf_base_massflux);
+      pointwise_update(c,
+                       (*m_salinity_ocean)(i,j),
+                       potential_temperature_celsius,
+                       ice_thickness(i,j),
+                       &shelf_base_temp_celsius,
+                       &shelf_base_massflux);
 
-    // Convert from Celsius to Kelvin:
-    temperature(i,j) = shelf_base_temp_celsius + 273.15;
-    mass_flux(i,j)   = shelf_base_massflux;
+      // Convert from Celsius to Kelvin:
+      temperature(i,j) = shelf_base_temp_celsius + 273.15;
+      mass_flux(i,j)   = shelf_base_massflux;
+    }
   }
 
   // convert mass flux from [m s-1] to [kg m-2 s-1]:
@@ -21,6 +21,7 @@
 
 #include "CompleteOceanModel.hh"
 #include "pism/util/iceModelVec2T.hh"
+#include "ShelfCells.hh"
 
 namespace pism {
 namespace ocean {
@@ -66,6 +67,9 @@ private:
   IceModelVec2T::Ptr m_theta_ocean;
   IceModelVec2T::Ptr m_salinity_ocean;
 
+  //! Grid points where the three-equation model has to be solved.
+  ShelfCells m_shelf_cells;
+
   void pointwise_update(const Constants &constants,
                         double sea_water_salinity,
                         double sea_water_potential_temperature,
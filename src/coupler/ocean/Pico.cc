@@ -232,6 +232,8 @@ void Pico::update_impl(const Geometry &geometry, double t, double dt) {
   // Geometric part of PICO
   m_geometry->update(bed_elevation, cell_type);
 
+  m_shelf_cells.update(*m_grid, cell_type);
+
   // FIXME: m_n_shelves is not really the number of shelves.
   m_n_shelves = m_geometry->ice_shelf_mask().max() + 1;
 
@@ -263,11 +265,16 @@ void Pico::update_impl(const Geometry &geometry, double t, double dt) {
                     m_Toc,
                     m_Soc);
 
+    // areas of all boxes in all shelves
+    std::vector<std::vector<double> > box_area;
+    compute_box_areas(m_geometry->ice_shelf_mask(), m_geometry->box_mask(), box_area);
+
     // In ice shelves, replace Beckmann-Goosse values using the Olbers and Hellmer model.
     process_box1(physics,
                  ice_thickness,                             // input
                  m_geometry->ice_shelf_mask(),              // input
                  m_geometry->box_mask(),                    // input
+                 box_area[1],                               // input
                  m_Toc_box0,                                // input
                  m_Soc_box0,                                // input
                  m_basal_melt_rate,
@@ -281,6 +288,7 @@ void Pico::update_impl(const Geometry &geometry, double t, double dt) {
                         ice_thickness,                // input
                         m_geometry->ice_shelf_mask(), // input
                         m_geometry->box_mask(),       // input
+                        box_area,                     // input
                         m_basal_melt_rate,
                         *m_shelf_base_temperature,
                         m_T_star,
@@ -315,14 +323,14 @@ void Pico::compute_ocean_input_per_basin(const PicoPhysics &physics, const IceMo
                                          const IceModelVec2S &salinity_ocean, const IceModelVec2S &theta_ocean,
                                          std::vector<double> &temperature, std::vector<double> &salinity) {
 
-  std::vector<int> count(m_n_basins, 0);
+  // local sums: the number of cells, salinity, and temperature for each basin (one
+  // reduction for all basins)
+  std::vector<double> local(3 * m_n_basins, 0.0), global(3 * m_n_basins, 0.0);
 
-  temperature.resize(m_n_basins);
-  salinity.resize(m_n_basins);
-  for (int basin_id = 0; basin_id < m_n_basins; basin_id++) {
-    temperature[basin_id] = 0.0;
-    salinity[basin_id]    = 0.0;
-  }
+  double
+    *count_local       = &local[0],
+    *salinity_local    = &local[m_n_basins],
+    *temperature_local = &local[2 * m_n_basins];
 
   IceModelVec::AccessList list{ &theta_ocean, &salinity_ocean, &basin_mask, &continental_shelf_mask };
 
@@ -335,24 +343,29 @@ void Pico::compute_ocean_input_per_basin(const PicoPhysics &physics, const IceMo
     if (continental_shelf_mask.as_int(i, j) == 2) {
       int basin_id = basin_mask.as_int(i, j);
 
-      count[basin_id] += 1;
-      salinity[basin_id] += salinity_ocean(i, j);
-      temperature[basin_id] += theta_ocean(i, j);
+      count_local[basin_id] += 1;
+      salinity_local[basin_id] += salinity_ocean(i, j);
+      temperature_local[basin_id] += theta_ocean(i, j);
     }
   }
 
+  GlobalSum(m_grid->com, local.data(), global.data(), local.size());
+
+  temperature.resize(m_n_basins);
+  salinity.resize(m_n_basins);
+
   // Divide by number of grid cells if more than zero cells belong to the basin. if no
   // ocean_contshelf_mask values intersect with the basin, count is zero. In such case,
   // use dummy temperature and salinity. This could happen, for example, if the ice shelf
   // front advances beyond the continental shelf break.
   for (int basin_id = 0; basin_id < m_n_basins; basin_id++) {
 
-    count[basin_id]       = GlobalSum(m_grid->com, count[basin_id]);
-    salinity[basin_id]    = GlobalSum(m_grid->com, salinity[basin_id]);
-    temperature[basin_id] = GlobalSum(m_grid->com, temperature[basin_id]);
+    const double count    = global[basin_id];
+    salinity[basin_id]    = global[m_n_basins + basin_id];
+    temperature[basin_id] = global[2 * m_n_basins + basin_id];
 
     // if basin is not dummy basin 0 or there are no ocean cells in this basin to take the mean over.
-    if (basin_id > 0 && count[basin_id] == 0) {
+    if (basin_id > 0 && count == 0) {
       m_log->message(2, "PICO ocean WARNING: basin %d contains no cells with ocean data on continental shelf\n"
                         "(no values with ocean_contshelf_mask=2).\n"
                         "No mean salinity or temperature values are computed, instead using\n"
@@ -365,8 +378,8 @@ void Pico::compute_ocean_input_per_basin(const PicoPhysics &physics, const IceMo
 
     } else {
 
-      salinity[basin_id] /= count[basin_id];
-      temperature[basin_id] /= count[basin_id];
+      salinity[basin_id] /= count;
+      temperature[basin_id] /= count;
 
       m_log->message(5, "  %d: temp =%.3f, salinity=%.3f\n", basin_id, temperature[basin_id], salinity[basin_id]);
     }
@@ -386,6 +399,10 @@ void Pico::set_ocean_input_fields(const PicoPhysics &physics, const IceModelVec2
                                   const std::vector<double> basin_salinity, IceModelVec2S &Toc_box0,
                                   IceModelVec2S &Soc_box0) {
 
+  // make sure all temperatures are zero at the beginning of each time step
+  Toc_box0.set(0.0); // in K
+  Soc_box0.set(0.0); // in psu
+
   IceModelVec::AccessList list{ &ice_thickness, &basin_mask, &Soc_box0, &Toc_box0, &mask, &shelf_mask };
 
   std::vector<std::vector<int> > n_shelf_cells_per_basin(m_n_shelves, std::vector<int>(m_n_basins, 0));
@@ -393,19 +410,28 @@ void Pico::set_ocean_input_fields(const PicoPhysics &physics, const IceModelVec2
 
   // 1) count the number of cells in each shelf
   // 2) count the number of cells in the intersection of each shelf with all the basins
+  //
+  // Note: shelf_mask is zero outside of floating ice areas.
   {
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
+    // counts for each shelf: m_n_basins values followed by the total (one reduction for
+    // all shelves and basins)
+    const int stride = m_n_basins + 1;
+    std::vector<double> local(m_n_shelves * stride, 0.0), global(m_n_shelves * stride, 0.0);
+
+    for (const auto &cell : m_shelf_cells.floating()) {
+      const int i = cell.i, j = cell.j;
       int s = shelf_mask.as_int(i, j);
       int b = basin_mask.as_int(i, j);
-      n_shelf_cells_per_basin[s][b]++;
-      n_shelf_cells[s]++;
+      local[s * stride + b] += 1;
+      local[s * stride + m_n_basins] += 1;
     }
 
+    GlobalSum(m_grid->com, local.data(), global.data(), local.size());
+
     for (int s = 0; s < m_n_shelves; s++) {
-      n_shelf_cells[s] = GlobalSum(m_grid->com, n_shelf_cells[s]);
+      n_shelf_cells[s] = global[s * stride + m_n_basins];
       for (int b = 0; b < m_n_basins; b++) {
-        n_shelf_cells_per_basin[s][b] = GlobalSum(m_grid->com, n_shelf_cells_per_basin[s][b]);
+        n_shelf_cells_per_basin[s][b] = global[s * stride + b];
       }
     }
   }
@@ -413,12 +439,8 @@ void Pico::set_ocean_input_fields(const PicoPhysics &physics, const IceModelVec2
   // now set potential temperature and salinity box 0:
 
   int low_temperature_counter = 0;
-  for (Points p(*m_grid); p; p.next()) {
-    const int i = p.i(), j = p.j();
-
-    // make sure all temperatures are zero at the beginning of each time step
-    Toc_box0(i, j) = 0.0; // in K
-    Soc_box0(i, j) = 0.0; // in psu
+  for (const auto &cell : m_shelf_cells.floating()) {
+    const int i = cell.i, j = cell.j;
 
     int s = shelf_mask.as_int(i, j);
 
@@ -476,8 +498,8 @@ void Pico::beckmann_goosse(const PicoPhysics &physics,
   IceModelVec::AccessList list{ &ice_thickness, &cell_type, &shelf_mask,      &Toc_box0,          &Soc_box0,
                                 &Toc,           &Soc,       &basal_melt_rate, &basal_temperature };
 
-  for (Points p(*m_grid); p; p.next()) {
-    const int i = p.i(), j = p.j();
+  for (const auto &cell : m_shelf_cells.floating()) {
+    const int i = cell.i, j = cell.j;
 
     if (cell_type.floating_ice(i, j)) {
       if (shelf_mask.as_int(i, j) > 0) {
@@ -506,6 +528,7 @@ void Pico::process_box1(const PicoPhysics &physics,
                         const IceModelVec2S &ice_thickness,
                         const IceModelVec2Int &shelf_mask,
                         const IceModelVec2Int &box_mask,
+                        const std::vector<double> &box1_area,
                         const IceModelVec2S &Toc_box0,
                         const IceModelVec2S &Soc_box0,
                         IceModelVec2S &basal_melt_rate,
@@ -515,10 +538,6 @@ void Pico::process_box1(const PicoPhysics &physics,
                         IceModelVec2S &Soc,
                         IceModelVec2S &overturning) {
 
-  std::vector<double> box1_area(m_n_shelves);
-
-  compute_box_area(1, shelf_mask, box_mask, box1_area);
-
   IceModelVec::AccessList list{ &ice_thickness, &shelf_mask, &box_mask,    &T_star,          &Toc_box0,          &Toc,
                                 &Soc_box0,      &Soc,        &overturning, &basal_melt_rate, &basal_temperature };
 
@@ -526,8 +545,8 @@ void Pico::process_box1(const PicoPhysics &physics,
 
   // basal melt rate, ambient temperature and salinity and overturning calculation
   // for each box1 grid cell.
-  for (Points p(*m_grid); p; p.next()) {
-    const int i = p.i(), j = p.j();
+  for (const auto &cell : m_shelf_cells.floating()) {
+    const int i = cell.i, j = cell.j;
 
     int shelf_id = shelf_mask.as_int(i, j);
 
@@ -573,6 +592,7 @@ void Pico::process_other_boxes(const PicoPhysics &physics,
                                const IceModelVec2S &ice_thickness,
                                const IceModelVec2Int &shelf_mask,
                                const IceModelVec2Int &box_mask,
+                               const std::vector<std::vector<double> > &box_area,
                                IceModelVec2S &basal_melt_rate,
                                IceModelVec2S &basal_temperature,
                                IceModelVec2S &T_star,
@@ -583,9 +603,6 @@ void Pico::process_other_boxes(const PicoPhysics &physics,
   std::vector<double> salinity(m_n_shelves, 0.0);
   std::vector<double> temperature(m_n_shelves, 0.0);
 
-  // get average overturning from box 1 that is used as input later
-  compute_box_average(1, m_overturning, shelf_mask, box_mask, overturning);
-
   std::vector<bool> use_beckmann_goosse(m_n_shelves);
 
   IceModelVec::AccessList list{ &ice_thickness, &shelf_mask,      &box_mask,           &T_star,   &Toc,
@@ -594,8 +611,23 @@ void Pico::process_other_boxes(const PicoPhysics &physics,
   // Iterate over all boxes i for i > 1
   for (int box = 2; box <= m_n_boxes; ++box) {
 
-    compute_box_average(box - 1, Toc, shelf_mask, box_mask, temperature);
-    compute_box_average(box - 1, Soc, shelf_mask, box_mask, salinity);
+    // get inputs from the previous box; the average overturning in box 1 is used as an
+    // input for all the boxes that follow
+    {
+      std::vector<const IceModelVec2S*> fields{&Toc, &Soc};
+      if (box == 2) {
+        fields.push_back(&m_overturning);
+      }
+
+      std::vector<std::vector<double> > averages;
+      compute_box_averages(box - 1, fields, shelf_mask, box_mask, averages);
+
+      temperature = averages[0];
+      salinity    = averages[1];
+      if (box == 2) {
+        overturning = averages[2];
+      }
+    }
 
     // find all the shelves where we should fall back to the Beckmann-Goosse
     // parameterization
@@ -607,13 +639,10 @@ void Pico::process_other_boxes(const PicoPhysics &physics,
       }
     }
 
-    std::vector<double> box_area;
-    compute_box_area(box, shelf_mask, box_mask, box_area);
-
     int n_beckmann_goosse_cells = 0;
 
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
+    for (const auto &cell : m_shelf_cells.floating()) {
+      const int i = cell.i, j = cell.j;
 
       int shelf_id = shelf_mask.as_int(i, j);
 
@@ -635,7 +664,7 @@ void Pico::process_other_boxes(const PicoPhysics &physics,
 
           // diagnostic outputs
           T_star(i, j) = physics.T_star(S_previous, T_previous, pressure);
-          Toc(i, j)    = physics.Toc(box_area[shelf_id], T_previous, T_star(i, j), overturning_box1, S_previous);
+          Toc(i, j)    = physics.Toc(box_area[box][shelf_id], T_previous, T_star(i, j), overturning_box1, S_previous);
           Soc(i, j)    = physics.Soc(S_previous, T_previous, Toc(i, j));
 
           // main outputs: basal melt rate and temperature
@@ -664,9 +693,10 @@ void Pico::extend_basal_melt_rates(const IceModelVec2CellType &cell_type, IceMod
 
   IceModelVec::AccessList list{&cell_type, &basal_melt_rate};
 
-  for (Points p(*m_grid); p; p.next()) {
+  // only cells next to floating ice can be partially filled
+  for (const auto &cell : m_shelf_cells.halo()) {
 
-    const int i = p.i(), j = p.j();
+    const int i = cell.i, j = cell.j;
 
     auto M = cell_type.int_box(i, j);
 
@@ -722,81 +752,103 @@ DiagnosticList Pico::diagnostics_impl() const {
 }
 
 /*!
- * For each shelf, compute average of a given field over the box with id `box_id`.
+ * For each shelf, compute averages of given fields over the box with id `box_id`.
  *
  * This method is used to get inputs from a previous box for the next one.
+ *
+ * Uses one pass over floating ice cells and one reduction for all fields and shelves.
+ *
+ * @param[out] result averages: `result[k][s]` is the average of `fields[k]` in shelf `s`
  */
-void Pico::compute_box_average(int box_id,
-                               const IceModelVec2S &field,
-                               const IceModelVec2Int &shelf_mask,
-                               const IceModelVec2Int &box_mask,
-                               std::vector<double> &result) {
+void Pico::compute_box_averages(int box_id,
+                                const std::vector<const IceModelVec2S*> &fields,
+                                const IceModelVec2Int &shelf_mask,
+                                const IceModelVec2Int &box_mask,
+                                std::vector<std::vector<double> > &result) {
 
-  IceModelVec::AccessList list{ &field, &shelf_mask, &box_mask };
+  IceModelVec::AccessList list{ &shelf_mask, &box_mask };
+  for (auto f : fields) {
+    list.add(*f);
+  }
 
-  std::vector<int> n_cells_per_box(m_n_shelves, 0);
+  const int N = fields.size();
 
-  // fill results with zeros
-  result.resize(m_n_shelves);
-  for (int s = 0; s < m_n_shelves; ++s) {
-    result[s] = 0.0;
-  }
+  // local sums: the number of cells in each shelf's box box_id, followed by sums of
+  // each field
+  std::vector<double> local((N + 1) * m_n_shelves, 0.0), global((N + 1) * m_n_shelves, 0.0);
 
-  // compute the sum of field in each shelf's box box_id
-  for (Points p(*m_grid); p; p.next()) {
-    const int i = p.i(), j = p.j();
+  // compute the sum of field in each shelf's box box_id (boxes contain floating ice only)
+  for (const auto &cell : m_shelf_cells.floating()) {
+    const int i = cell.i, j = cell.j;
 
     int shelf_id = shelf_mask.as_int(i, j);
 
     if (box_mask.as_int(i, j) == box_id) {
-      n_cells_per_box[shelf_id] += 1;
-      result[shelf_id] += field(i, j);
+      local[shelf_id] += 1;
+      for (int k = 0; k < N; ++k) {
+        local[(k + 1) * m_n_shelves + shelf_id] += (*fields[k])(i, j);
+      }
     }
   }
 
   // compute the global sum and average
-  for (int s = 0; s < m_n_shelves; ++s) {
-    auto n_cells = GlobalSum(m_grid->com, n_cells_per_box[s]);
+  GlobalSum(m_grid->com, local.data(), global.data(), local.size());
+
+  result.resize(N);
+  for (int k = 0; k < N; ++k) {
+    result[k].resize(m_n_shelves);
+    for (int s = 0; s < m_n_shelves; ++s) {
+      const double n_cells = global[s];
 
-    result[s] = GlobalSum(m_grid->com, result[s]);
+      result[k][s] = global[(k + 1) * m_n_shelves + s];
 
-    if (n_cells > 0) {
-      result[s] /= (double)n_cells;
+      if (n_cells > 0) {
+        result[k][s] /= n_cells;
+      }
     }
   }
 }
 
 /*!
- * For all shelves compute areas of boxes with id `box_id`.
+ * For all shelves compute areas of all boxes.
  *
+ * @param[in] shelf_mask ice shelf index mask
  * @param[in] box_mask box index mask
- * @param[out] result resulting box areas.
+ * @param[out] result resulting box areas: `result[b][s]` is the area of the box `b` in
+ *                    the shelf `s`
  *
  * Note: shelf and box indexes start from 1.
  */
-void Pico::compute_box_area(int box_id,
-                            const IceModelVec2Int &shelf_mask,
-                            const IceModelVec2Int &box_mask,
-                            std::vector<double> &result) {
-  result.resize(m_n_shelves);
+void Pico::compute_box_areas(const IceModelVec2Int &shelf_mask,
+                             const IceModelVec2Int &box_mask,
+                             std::vector<std::vector<double> > &result) {
 
   IceModelVec::AccessList list{ &shelf_mask, &box_mask };
 
   auto cell_area = m_grid->cell_area();
 
-  for (Points p(*m_grid); p; p.next()) {
-    const int i = p.i(), j = p.j();
+  const int n_boxes = m_n_boxes + 1;
+
+  std::vector<double> local(n_boxes * m_n_shelves, 0.0), global(n_boxes * m_n_shelves, 0.0);
+
+  for (const auto &cell : m_shelf_cells.floating()) {
+    const int i = cell.i, j = cell.j;
 
     int shelf_id = shelf_mask.as_int(i, j);
+    int box_id   = box_mask.as_int(i, j);
 
-    if (shelf_id > 0 and box_mask.as_int(i, j) == box_id) {
-      result[shelf_id] += cell_area;
+    if (shelf_id > 0 and box_id > 0 and box_id < n_boxes) {
+      local[box_id * m_n_shelves + shelf_id] += cell_area;
     }
   }
 
   // compute global sums
-  for (int s = 1; s < m_n_shelves; ++s) {
-    result[s] = GlobalSum(m_grid->com, result[s]);
+  GlobalSum(m_grid->com, local.data(), global.data(), local.size());
+
+  result.resize(n_boxes);
+  for (int b = 0; b < n_boxes; ++b) {
+    result[b].assign(global.begin() + b * m_n_shelves,
+                     global.begin() + (b + 1) * m_n_shelves);
   }
 }
 
@@ -24,6 +24,7 @@
 
 #include "pism/util/IceModelVec2CellType.hh"
 #include "pism/util/iceModelVec2T.hh"
+#include "ShelfCells.hh"
 
 namespace pism {
 namespace ocean {
@@ -61,6 +62,9 @@ private:
 
   std::unique_ptr<PicoGeometry> m_geometry;
 
+  //! Floating ice cells and their neighbors (the rest of the domain is skipped).
+  ShelfCells m_shelf_cells;
+
   IceModelVec2T::Ptr m_theta_ocean, m_salinity_ocean;
 
   void compute_ocean_input_per_basin(const PicoPhysics &physics,
@@ -85,6 +89,7 @@ private:
                     const IceModelVec2S &ice_thickness,
                     const IceModelVec2Int &shelf_mask,
                     const IceModelVec2Int &box_mask,
+                    const std::vector<double> &box1_area,
                     const IceModelVec2S &Toc_box0,
                     const IceModelVec2S &Soc_box0,
                     IceModelVec2S &basal_melt_rate,
@@ -98,6 +103,7 @@ private:
                            const IceModelVec2S &ice_thickness,
                            const IceModelVec2Int &shelf_mask,
                            const IceModelVec2Int &box_mask,
+                           const std::vector<std::vector<double> > &box_area,
                            IceModelVec2S &basal_melt_rate,
                            IceModelVec2S &basal_temperature,
                            IceModelVec2S &T_star,
@@ -117,16 +123,15 @@ private:
                        IceModelVec2S &Toc,
                        IceModelVec2S &Soc);
 
-  void compute_box_average(int box_id,
-                           const IceModelVec2S &field,
-                           const IceModelVec2Int &shelf_mask,
-                           const IceModelVec2Int &box_mask,
-                           std::vector<double> &result);
+  void compute_box_averages(int box_id,
+                            const std::vector<const IceModelVec2S*> &fields,
+                            const IceModelVec2Int &shelf_mask,
+                            const IceModelVec2Int &box_mask,
+                            std::vector<std::vector<double> > &result);
 
-  void compute_box_area(int box_id,
-                        const IceModelVec2Int &shelf_mask,
-                        const IceModelVec2Int &box_mask,
-                        std::vector<double> &result);
+  void compute_box_areas(const IceModelVec2Int &shelf_mask,
+                         const IceModelVec2Int &box_mask,
+                         std::vector<std::vector<double> > &result);
 
 
   int m_n_basins, m_n_boxes, m_n_shelves;
@@ -0,0 +1,72 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "ShelfCells.hh"
+
+#include "pism/util/IceGrid.hh"
+#include "pism/util/IceModelVec2CellType.hh"
+#include "pism/util/Mask.hh"
+
+namespace pism {
+namespace ocean {
+
+void ShelfCells::update(const IceGrid &grid, const IceModelVec2CellType &cell_type) {
+  // clear() keeps allocated storage, so after the first call this does not allocate
+  // unless ice shelves grow
+  m_floating.clear();
+  m_halo.clear();
+
+  IceModelVec::AccessList list(cell_type);
+
+  for (Points p(grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    auto M = cell_type.int_box(i, j);
+
+    if (mask::floating_ice(M.ij)) {
+      m_floating.push_back({i, j});
+      continue;
+    }
+
+    bool next_to_floating_ice =
+      mask::floating_ice(M.n) or mask::floating_ice(M.e) or
+      mask::floating_ice(M.s) or mask::floating_ice(M.w) or
+      mask::floating_ice(M.ne) or mask::floating_ice(M.nw) or
+      mask::floating_ice(M.se) or mask::floating_ice(M.sw);
+
+    // ice-free ocean at a calving front of grounded ice may be filled with floating ice
+    // during the next time step
+    bool ocean_next_to_ice = mask::ice_free_ocean(M.ij) and cell_type.next_to_ice(i, j);
+
+    if (next_to_floating_ice or ocean_next_to_ice) {
+      m_halo.push_back({i, j});
+    }
+  }
+}
+
+const std::vector<ShelfCells::Index>& ShelfCells::floating() const {
+  return m_floating;
+}
+
+const std::vector<ShelfCells::Index>& ShelfCells::halo() const {
+  return m_halo;
+}
+
+} // end of namespace ocean
+} // end of namespace pism
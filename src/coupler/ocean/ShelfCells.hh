@@ -0,0 +1,65 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_OCEAN_SHELFCELLS_H
+#define PISM_OCEAN_SHELFCELLS_H
+
+#include <vector>
+
+namespace pism {
+
+class IceGrid;
+class IceModelVec2CellType;
+
+namespace ocean {
+
+//! Lists of grid points (owned by this process) where sub-shelf melt is needed.
+/*!
+ * Sub-shelf melt rates and temperatures are used under floating ice and in cells next
+ * to it (partially floating cells at the grounding line, ice-free ocean cells at the
+ * calving front). Ocean models use these lists to skip the rest of the domain, so that
+ * the cost of an update is proportional to the area of ice shelves.
+ *
+ * Both lists are sorted in the order used by `Points` (`j` is the outer index).
+ *
+ * Requires ghosts of the cell type mask (stencil width of at least 1).
+ */
+class ShelfCells {
+public:
+  struct Index {
+    int i, j;
+  };
+
+  void update(const IceGrid &grid, const IceModelVec2CellType &cell_type);
+
+  //! Floating ice cells.
+  const std::vector<Index>& floating() const;
+
+  //! Cells that are not floating, but are next to floating ice (in the 3x3 box), and
+  //! ice-free ocean cells next to ice.
+  const std::vector<Index>& halo() const;
+private:
+  std::vector<Index> m_floating;
+  std::vector<Index> m_halo;
+};
+
+} // end of namespace ocean
+} // end of namespace pism
+
+#endif /* PISM_OCEAN_SHELFCELLS_H */
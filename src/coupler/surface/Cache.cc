@@ -22,15 +22,87 @@
 
 #include "Cache.hh"
 #include "pism/util/Time.hh"
+#include "pism/util/Time_Calendar.hh"
 #include "pism/util/pism_options.hh"
 #include "pism/util/IceGrid.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/MaxTimestep.hh"
+#include "pism/util/CompactMask.hh"
+#include "pism/geometry/Geometry.hh"
 
 namespace pism {
 namespace surface {
 
+//! Outputs of the input model computed at a given position within the period of the
+//! forcing.
+struct Cache::Record {
+  Record(IceGrid::ConstPtr grid, const std::vector<IceModelVec2S*> &outputs);
+
+  bool matches(const Geometry &geometry, double tolerance) const;
+  void store(const Geometry &geometry, const std::vector<IceModelVec2S*> &outputs);
+
+  //! position within the period of the forcing, in seconds
+  double phase;
+
+  //! surface elevation and the cell type mask used to compute stored fields
+  IceModelVec2S surface_elevation;
+  CompactMask cell_type;
+
+  std::vector<IceModelVec2S::Ptr> fields;
+};
+
+Cache::Record::Record(IceGrid::ConstPtr grid, const std::vector<IceModelVec2S*> &outputs)
+  : phase(0.0),
+    surface_elevation(grid, "usurf", WITHOUT_GHOSTS),
+    cell_type(grid, "mask", 0) {
+
+  for (auto f : outputs) {
+    fields.emplace_back(new IceModelVec2S(grid, f->get_name(), WITHOUT_GHOSTS));
+  }
+}
+
+//! Returns true if stored fields were computed using the geometry close to `geometry`.
+bool Cache::Record::matches(const Geometry &geometry, double tolerance) const {
+  const IceGrid &grid = *surface_elevation.grid();
+
+  IceModelVec::AccessList list{&geometry.ice_surface_elevation, &geometry.cell_type,
+                               &surface_elevation, &cell_type};
+
+  double match = 1.0;
+  for (Points p(grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    if (geometry.cell_type.as_int(i, j) != cell_type(i, j) or
+        fabs(geometry.ice_surface_elevation(i, j) - surface_elevation(i, j)) >= tolerance) {
+      match = 0.0;
+      break;
+    }
+  }
+
+  return GlobalMin(grid.com, match) > 0.5;
+}
+
+void Cache::Record::store(const Geometry &geometry, const std::vector<IceModelVec2S*> &outputs) {
+  const IceGrid &grid = *surface_elevation.grid();
+
+  {
+    IceModelVec::AccessList list{&geometry.ice_surface_elevation, &geometry.cell_type,
+                                 &surface_elevation, &cell_type};
+
+    for (Points p(grid); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      surface_elevation(i, j) = geometry.ice_surface_elevation(i, j);
+      cell_type.set(i, j, geometry.cell_type.as_int(i, j));
+    }
+  }
+
+  for (unsigned int k = 0; k < outputs.size(); ++k) {
+    fields[k]->copy_from(*outputs[k]);
+  }
+}
+
 Cache::Cache(IceGrid::ConstPtr grid, std::shared_ptr<SurfaceModel> in)
   : SurfaceModel(grid, in) {
 
@@ -42,6 +114,42 @@ Cache::Cache(IceGrid::ConstPtr grid, std::shared_ptr<SurfaceModel> in)
                                   "surface.cache.update_interval has to be strictly positive.");
   }
 
+  m_period_years                = m_config->get_number("surface.cache.period", "years");
+  m_surface_elevation_tolerance = m_config->get_number("surface.cache.surface_elevation_tolerance");
+
+  if (m_period_years > 0) {
+    // Time_Calendar::mod() does not support periodic forcing, so positions within the
+    // period would never repeat and stored results would never be re-used.
+    auto time = m_grid->ctx()->time();
+    if (dynamic_cast<const Time_Calendar*>(time.get()) != nullptr) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "surface.cache.period > 0 requires a calendar with years"
+                                    " of equal length (360_day, 365_day, noleap, or none);"
+                                    " got '%s'", time->calendar().c_str());
+    }
+
+    if (m_period_years % m_update_interval_years != 0) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "surface.cache.period (%d years) has to be a multiple of"
+                                    " surface.cache.update_interval (%d years).",
+                                    m_period_years, m_update_interval_years);
+    }
+
+    // Stored results are re-used *instead* of updating the input model, so the input model
+    // cannot have state that evolves from one update to the next. Models preceding "cache"
+    // in the chain are inputs of this modifier.
+    for (auto model : split(m_config->get_string("surface.models"), ',')) {
+      if (model == "cache") {
+        break;
+      }
+      if (model == "pdd") {
+        throw RuntimeError(PISM_ERROR_LOCATION,
+                           "surface.cache.period > 0 cannot be used with the 'pdd' surface model:"
+                           " it keeps track of the firn and snow depth between updates.");
+      }
+    }
+  }
+
   {
     m_mass_flux             = allocate_mass_flux(grid);
     m_temperature           = allocate_temperature(grid);
@@ -63,7 +171,21 @@ void Cache::init_impl(const Geometry &geometry) {
 
   m_log->message(2, "* Initializing the 'caching' surface model modifier...\n");
 
+  if (m_period_years > 0) {
+    m_log->message(2, "  Storing results for re-use during later %d-year periods of the forcing...\n"
+                   "  (up to %d records, 10 2D fields each)\n",
+                   m_period_years, m_period_years / m_update_interval_years);
+  }
+
   m_next_update_time = m_grid->ctx()->time()->current();
+  m_records.clear();
+}
+
+//! Outputs of this model, in the order used by Record.
+std::vector<IceModelVec2S*> Cache::outputs() {
+  return {m_mass_flux.get(), m_temperature.get(), m_liquid_water_fraction.get(),
+          m_layer_mass.get(), m_layer_thickness.get(), m_accumulation.get(),
+          m_melt.get(), m_runoff.get()};
 }
 
 void Cache::update_impl(const Geometry &geometry, double t, double dt) {
@@ -79,11 +201,35 @@ void Cache::update_impl(const Geometry &geometry, double t, double dt) {
 
     assert(update_dt > 0.0);
 
-    m_input_model->update(geometry, t, update_dt);
-
     m_next_update_time = m_grid->ctx()->time()->increment_date(m_next_update_time,
                                                                m_update_interval_years);
 
+    // Look for results computed at the same position within the period of the forcing.
+    std::shared_ptr<Record> record;
+    double phase = 0.0;
+    if (m_period_years > 0) {
+      phase = m_grid->ctx()->time()->mod(t, m_period_years);
+
+      for (auto r : m_records) {
+        if (fabs(r->phase - phase) < 1.0) {
+          record = r;
+          break;
+        }
+      }
+
+      if (record and record->matches(geometry, m_surface_elevation_tolerance)) {
+        m_log->message(3, "  surface cache: re-using stored results\n");
+
+        auto fields = outputs();
+        for (unsigned int k = 0; k < fields.size(); ++k) {
+          fields[k]->copy_from(*record->fields[k]);
+        }
+        return;
+      }
+    }
+
+    m_input_model->update(geometry, t, update_dt);
+
     // store outputs of the input model
     m_mass_flux->copy_from(m_input_model->mass_flux());
     m_temperature->copy_from(m_input_model->temperature());
@@ -93,6 +239,17 @@ void Cache::update_impl(const Geometry &geometry, double t, double dt) {
     m_accumulation->copy_from(m_input_model->accumulation());
     m_melt->copy_from(m_input_model->melt());
     m_runoff->copy_from(m_input_model->runoff());
+
+    if (m_period_years > 0) {
+      if (not record and m_records.size() < m_period_years / m_update_interval_years) {
+        record.reset(new Record(m_grid, outputs()));
+        m_records.push_back(record);
+      }
+      if (record) {
+        record->phase = phase;
+        record->store(geometry, outputs());
+      }
+    }
   }
 }
 
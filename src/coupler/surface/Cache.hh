@@ -51,6 +51,17 @@ protected:
 
   double m_next_update_time;
   unsigned int m_update_interval_years;
+
+  //! period of the climate forcing, in years (zero if results should not be stored)
+  unsigned int m_period_years;
+  double m_surface_elevation_tolerance;
+
+  struct Record;
+  //! results stored for re-use during later periods of the forcing (at most
+  //! m_period_years / m_update_interval_years records)
+  std::vector<std::shared_ptr<Record> > m_records;
+
+  std::vector<IceModelVec2S*> outputs();
 };
 
 } // end of namespace surface
@@ -28,7 +28,8 @@ namespace pism {
 namespace surface {
 
 ElevationChange::ElevationChange(IceGrid::ConstPtr g, std::shared_ptr<SurfaceModel> in)
-  : SurfaceModel(g, in) {
+  : SurfaceModel(g, in),
+    m_elevation_change(g, m_config->get_number("surface.elevation_change.surface_elevation_tolerance")) {
 
   {
     m_smb_lapse_rate = m_config->get_number("surface.elevation_change.smb.lapse_rate",
@@ -47,6 +48,10 @@ ElevationChange::ElevationChange(IceGrid::ConstPtr g, std::shared_ptr<SurfaceMod
   m_temp_lapse_rate = m_config->get_number("surface.elevation_change.temperature_lapse_rate",
                                            "K / m");
 
+  if (m_smb_method == SCALE) {
+    m_elevation_change.enable_scaling(m_temp_lapse_rate, m_smb_exp_factor);
+  }
+
   {
     ForcingOptions opt(*m_grid->ctx(), "surface.elevation_change");
 
@@ -113,34 +118,21 @@ void ElevationChange::update_impl(const Geometry &geometry, double t, double dt)
   m_reference_surface->update(t, dt);
   m_reference_surface->interp(t + 0.5*dt);
 
-  const IceModelVec2S &surface = geometry.ice_surface_elevation;
+  // re-computes elevation changes only where necessary (see ElevationChangeCache)
+  m_elevation_change.update(geometry.ice_surface_elevation, *m_reference_surface);
 
   m_temperature->copy_from(m_input_model->temperature());
-  lapse_rate_correction(surface, *m_reference_surface,
-                        m_temp_lapse_rate, *m_temperature);
+  m_elevation_change.shift(m_temp_lapse_rate, *m_temperature);
 
   m_mass_flux->copy_from(m_input_model->mass_flux());
 
   switch (m_smb_method) {
   case SCALE:
-    {
-      IceModelVec::AccessList list{&surface, m_reference_surface.get(), m_mass_flux.get()};
-
-      for (Points p(*m_grid); p; p.next()) {
-        const int i = p.i(), j = p.j();
-
-        double dT = -m_temp_lapse_rate * (surface(i, j) - (*m_reference_surface)(i, j));
-
-        (*m_mass_flux)(i, j) *= exp(m_smb_exp_factor * dT);
-      }
-    }
+    m_elevation_change.scale(*m_mass_flux);
     break;
   default:
   case SHIFT:
-    {
-      lapse_rate_correction(surface, *m_reference_surface,
-                            m_smb_lapse_rate, *m_mass_flux);
-    }
+    m_elevation_change.shift(m_smb_lapse_rate, *m_mass_flux);
     break;
   }
 
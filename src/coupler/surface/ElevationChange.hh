@@ -22,6 +22,7 @@
 #include "pism/coupler/SurfaceModel.hh"
 
 #include "pism/util/iceModelVec2T.hh"
+#include "pism/coupler/util/lapse_rates.hh"
 
 namespace pism {
 namespace surface {
@@ -51,6 +52,8 @@ protected:
 
   IceModelVec2T::Ptr m_reference_surface;
 
+  ElevationChangeCache m_elevation_change;
+
   IceModelVec2S::Ptr m_mass_flux;
   IceModelVec2S::Ptr m_temperature;
 };
@@ -177,6 +177,7 @@ SurfaceModel::~SurfaceModel() {
  * Basic surface models currently implemented in PISM do not model accumulation
  */
 const IceModelVec2S& SurfaceModel::accumulation() const {
+  m_dummy_accumulation.compute();
   return accumulation_impl();
 }
 
@@ -185,6 +186,7 @@ const IceModelVec2S& SurfaceModel::accumulation() const {
  * Basic surface models currently implemented in PISM do not model melt
  */
 const IceModelVec2S& SurfaceModel::melt() const {
+  m_dummy_melt.compute();
   return melt_impl();
 }
 
@@ -193,6 +195,7 @@ const IceModelVec2S& SurfaceModel::melt() const {
  * Basic surface models currently implemented in PISM do not model runoff
  */
 const IceModelVec2S& SurfaceModel::runoff() const {
+  m_dummy_runoff.compute();
   return runoff_impl();
 }
 
@@ -368,6 +371,34 @@ MaxTimestep SurfaceModel::max_timestep_impl(double t) const {
   return MaxTimestep("surface model");
 }
 
+SurfaceModel::DummyOutput::DummyOutput()
+  : smb(NULL), result(NULL), sign(1.0) {
+  // empty
+}
+
+void SurfaceModel::DummyOutput::request(const IceModelVec2S &input, IceModelVec2S &output,
+                                        double input_sign) {
+  smb    = &input;
+  result = &output;
+  sign   = input_sign;
+}
+
+//! Compute the requested output (if any).
+void SurfaceModel::DummyOutput::compute() {
+  if (smb == NULL) {
+    return;
+  }
+
+  IceModelVec::AccessList list{result, smb};
+
+  for (Points p(*result->grid()); p; p.next()) {
+    const int i = p.i(), j = p.j();
+    (*result)(i, j) = std::max(sign * (*smb)(i, j), 0.0);
+  }
+
+  smb = NULL;
+}
+
 /*!
  * Use the surface mass balance to compute dummy accumulation.
  *
@@ -377,15 +408,12 @@ MaxTimestep SurfaceModel::max_timestep_impl(double t) const {
  * We assume that the positive part of the SMB is accumulation and the negative part is
  * runoff. This ensures that outputs of PISM's surface models satisfy "SMB = accumulation
  * - runoff".
+ *
+ * Accumulation is computed when it is first used (usually by a diagnostic), so `smb` and
+ * `result` should not be modified until the next update.
  */
 void SurfaceModel::dummy_accumulation(const IceModelVec2S& smb, IceModelVec2S& result) {
-
-  IceModelVec::AccessList list{&result, &smb};
-
-  for (Points p(*m_grid); p; p.next()) {
-    const int i = p.i(), j = p.j();
-    result(i,j) = std::max(smb(i,j), 0.0);
-  }
+  m_dummy_accumulation.request(smb, result, 1.0);
 }
 
 /*!
@@ -397,15 +425,11 @@ void SurfaceModel::dummy_accumulation(const IceModelVec2S& smb, IceModelVec2S& r
  * We assume that the positive part of the SMB is accumulation and the negative part is
  * runoff. This ensures that outputs of PISM's surface models satisfy "SMB = accumulation
  * - runoff".
+ *
+ * See dummy_accumulation() for the note about lazy evaluation.
  */
 void SurfaceModel::dummy_runoff(const IceModelVec2S& smb, IceModelVec2S& result) {
-
-  IceModelVec::AccessList list{&result, &smb};
-
-  for (Points p(*m_grid); p; p.next()) {
-    const int i = p.i(), j = p.j();
-    result(i,j) = std::max(-smb(i,j), 0.0);
-  }
+  m_dummy_runoff.request(smb, result, -1.0);
 }
 
 /*!
@@ -418,7 +442,7 @@ void SurfaceModel::dummy_runoff(const IceModelVec2S& smb, IceModelVec2S& result)
  * quantity.
  */
 void SurfaceModel::dummy_melt(const IceModelVec2S& smb, IceModelVec2S& result) {
-  dummy_runoff(smb, result);
+  m_dummy_melt.request(smb, result, -1.0);
 }
 
 namespace diagnostics {
@@ -17,6 +17,8 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <algorithm>            // std::min
+#include <map>
+#include <cmath>                // floor
 
 #include "TemperatureIndex.hh"
 #include "localMassBalance.hh"
@@ -37,6 +39,52 @@
 namespace pism {
 namespace surface {
 
+/*!
+ * Find blocks of `block_size` by `block_size` grid cells (aligned with the global grid)
+ * that intersect the sub-domain of this process and are shared with other processes.
+ *
+ * Returns a map from the block index to ranks of processes owning parts of the block, in
+ * ascending order.
+ */
+static std::map<int, std::vector<int> > shared_blocks(const IceGrid &grid, int block_size) {
+  const int
+    xs         = grid.xs(),
+    xm         = grid.xm(),
+    ys         = grid.ys(),
+    ym         = grid.ym(),
+    b          = block_size,
+    n_blocks_x = (grid.Mx() - 1) / b + 1,
+    size       = grid.size();
+
+  // sub-domains of all processes (xs, xm, ys, ym)
+  std::vector<int> domains(4 * size);
+  {
+    int domain[4] = {xs, xm, ys, ym};
+    MPI_Allgather(domain, 4, MPI_INT, domains.data(), 4, MPI_INT, grid.com);
+  }
+
+  std::map<int, std::vector<int> > result;
+
+  for (int j0 = (ys / b) * b; j0 < ys + ym; j0 += b) {
+    for (int i0 = (xs / b) * b; i0 < xs + xm; i0 += b) {
+      std::vector<int> owners;
+      for (int r = 0; r < size; ++r) {
+        const int *d = &domains[4 * r];
+        if (d[0] < i0 + b and i0 < d[0] + d[1] and
+            d[2] < j0 + b and j0 < d[2] + d[3]) {
+          owners.push_back(r);
+        }
+      }
+
+      if (owners.size() > 1) {
+        result[(j0 / b) * n_blocks_x + i0 / b] = owners;
+      }
+    }
+  }
+
+  return result;
+}
+
 ///// PISM surface model implementing a PDD scheme.
 
 TemperatureIndex::TemperatureIndex(IceGrid::ConstPtr g,
@@ -44,7 +92,8 @@ TemperatureIndex::TemperatureIndex(IceGrid::ConstPtr g,
   : SurfaceModel(g, input),
     m_mass_flux(m_grid, "climatic_mass_balance", WITHOUT_GHOSTS),
     m_firn_depth(m_grid, "firn_depth", WITHOUT_GHOSTS),
-    m_snow_depth(m_grid, "snow_depth", WITHOUT_GHOSTS) {
+    m_snow_depth(m_grid, "snow_depth", WITHOUT_GHOSTS),
+    m_air_temp_sd_used(m_grid, "air_temp_sd", WITHOUT_GHOSTS) {
 
   m_sd_period                  = m_config->get_number("surface.pdd.std_dev.period");
   m_base_ddf.snow              = m_config->get_number("surface.pdd.factor_snow");
@@ -57,6 +106,26 @@ TemperatureIndex::TemperatureIndex(IceGrid::ConstPtr g,
 
   bool use_fausto_params     = m_config->get_flag("surface.pdd.fausto.enabled");
 
+  m_elevation_classes            = m_config->get_flag("surface.pdd.elevation_classes.enabled");
+  m_elevation_classes_bin_width  = m_config->get_number("surface.pdd.elevation_classes.bin_width");
+  m_elevation_classes_block_size = m_config->get_number("surface.pdd.elevation_classes.block_size");
+
+  if (m_elevation_classes) {
+    if (m_elevation_classes_bin_width <= 0.0) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "surface.pdd.elevation_classes.bin_width has to be positive (got %f)",
+                                    m_elevation_classes_bin_width);
+    }
+    if (m_elevation_classes_block_size < 1) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "surface.pdd.elevation_classes.block_size has to be positive (got %d)",
+                                    m_elevation_classes_block_size);
+    }
+
+    // the domain decomposition does not change, so shared blocks are found once
+    m_shared_blocks = shared_blocks(*m_grid, m_elevation_classes_block_size);
+  }
+
   std::string method = m_config->get_string("surface.pdd.method");
 
   if (method == "repeatable_random_process") {
@@ -95,6 +164,10 @@ TemperatureIndex::TemperatureIndex(IceGrid::ConstPtr g,
                            "standard deviation of near-surface air temperature",
                            "Kelvin", "Kelvin", "", 0);
 
+  m_air_temp_sd_used.set_attrs("diagnostic",
+                               "standard deviation of near-surface air temperature",
+                               "Kelvin", "Kelvin", "", 0);
+
   m_mass_flux.set_attrs("diagnostic",
                         "instantaneous surface mass balance (accumulation/ablation) rate",
                         "kg m-2 s-1", "kg m-2 s-1",
@@ -141,6 +214,14 @@ void TemperatureIndex::init_impl(const Geometry &geometry) {
                    "  Computing number of positive degree-days by: %s.\n",
                    m_mbscheme->method().c_str());
 
+    if (m_elevation_classes) {
+      m_log->message(2,
+                     "  Computing PDDs and snow accumulation using %.0f m elevation classes\n"
+                     "  in blocks of %dx%d grid cells.\n",
+                     m_elevation_classes_bin_width,
+                     m_elevation_classes_block_size, m_elevation_classes_block_size);
+    }
+
     if (m_faustogreve) {
       m_log->message(2,
                      "  Setting PDD parameters from [Faustoetal2009].\n");
@@ -157,6 +238,7 @@ void TemperatureIndex::init_impl(const Geometry &geometry) {
       m_log->message(2,
                      "  Using constant standard deviation of near-surface temperature.\n");
       m_air_temp_sd->init_constant(m_base_pddStdDev);
+      m_air_temp_sd_used.set(m_base_pddStdDev);
     } else {
       m_log->message(2,
                      "  Reading standard deviation of near-surface temperature from '%s'...\n",
@@ -250,7 +332,7 @@ void TemperatureIndex::update_impl(const Geometry &geometry, double t, double dt
   int N = m_mbscheme->get_timeseries_length(dt);
 
   const double dtseries = dt / N;
-  std::vector<double> ts(N), T(N), S(N), P(N), PDDs(N);
+  std::vector<double> ts(N), T(N), S(N), P(N);
   for (int k = 0; k < N; ++k) {
     ts[k] = t + k * dtseries;
   }
@@ -264,8 +346,8 @@ void TemperatureIndex::update_impl(const Geometry &geometry, double t, double dt
   const IceModelVec2CellType &mask = geometry.cell_type;
   const IceModelVec2S        &H    = geometry.ice_thickness;
 
-  IceModelVec::AccessList list{&mask, &H, m_air_temp_sd.get(), &m_mass_flux,
-                               &m_firn_depth, &m_snow_depth,
+  IceModelVec::AccessList list{&mask, &H, m_air_temp_sd.get(), &m_air_temp_sd_used,
+                               &m_mass_flux, &m_firn_depth, &m_snow_depth,
                                m_accumulation.get(), m_melt.get(), m_runoff.get()};
 
   const double
@@ -279,6 +361,10 @@ void TemperatureIndex::update_impl(const Geometry &geometry, double t, double dt
     list.add(*latitude);
   }
 
+  if (m_elevation_classes) {
+    list.add(geometry.ice_surface_elevation);
+  }
+
   if (fausto_greve) {
     const IceModelVec2S
       *longitude        = &geometry.latitude,
@@ -295,156 +381,480 @@ void TemperatureIndex::update_impl(const Geometry &geometry, double t, double dt
 
   const double ice_density = m_config->get_number("constants.ice.density");
 
-  ParallelSection loop(m_grid->com);
-  try {
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      // the temperature time series from the AtmosphereModel and its modifiers
-      m_atmosphere->temp_time_series(i, j, T);
+  // Collects inputs of the PDD scheme at (i, j) into T, S, and P. Returns false at points
+  // that do not need a mass balance computation (ice-free ocean).
+  auto collect = [&](int i, int j) {
+    // interpolate temperature standard deviation time series
+    if (m_sd_file_set) {
+      m_air_temp_sd->interp(i, j, S);
+    } else {
+      double tmp = (*m_air_temp_sd)(i, j);
+      for (int k = 0; k < N; ++k) {
+        S[k] = tmp;
+      }
+    }
 
-      if (mask.ice_free_ocean(i, j)) {
-        // ignore precipitation over ice-free ocean
-        for (int k = 0; k < N; ++k) {
-          P[k] = 0.0;
-        }
-      } else {
-        // elsewhere, get precipitation from the atmosphere model
-        m_atmosphere->precip_time_series(i, j, P);
+    // apply standard deviation lapse rate on top of prescribed values
+    if (sigmalapserate != 0.0) {
+      double lat = (*latitude)(i, j);
+      for (int k = 0; k < N; ++k) {
+        S[k] += sigmalapserate * (lat - sigmabaselat);
       }
+    }
+    // note: this does not modify m_air_temp_sd, so calling collect() more than once at a
+    // point gives the same result
+    m_air_temp_sd_used(i, j) = S[0]; // ensure correct SD reporting
+
+    if (mask.ice_free_ocean(i, j)) {
+      // Ignore precipitation and melt over ice-free ocean: there is no accumulation,
+      // melt, or runoff, and no firn or snow (snow over the ocean does not stick).
+      m_firn_depth(i, j)      = 0.0;
+      m_snow_depth(i, j)      = 0.0;
+      (*m_accumulation)(i, j) = 0.0;
+      (*m_melt)(i, j)         = 0.0;
+      (*m_runoff)(i, j)       = 0.0;
+      m_mass_flux(i, j)       = 0.0;
+      return false;
+    }
 
-      // convert precipitation from "kg m-2 second-1" to "m second-1" (PDDMassBalance expects
-      // accumulation in m/second ice equivalent)
+    // the temperature time series from the AtmosphereModel and its modifiers
+    m_atmosphere->temp_time_series(i, j, T);
+
+    m_atmosphere->precip_time_series(i, j, P);
+
+    // convert precipitation from "kg m-2 second-1" to "m second-1" (PDDMassBalance
+    // expects accumulation in m/second ice equivalent)
+    for (int k = 0; k < N; ++k) {
+      P[k] = P[k] / ice_density;
+      // kg / (m^2 * second) / (kg / m^3) = m / second
+    }
+
+    // apply standard deviation param over ice if in use
+    if (m_sd_use_param and mask.icy(i, j)) {
       for (int k = 0; k < N; ++k) {
-        P[k] = P[k] / ice_density;
-        // kg / (m^2 * second) / (kg / m^3) = m / second
+        S[k] = m_sd_param_a * (T[k] - 273.15) + m_sd_param_b;
+        if (S[k] < 0.0) {
+          S[k] = 0.0 ;
+        }
       }
+      m_air_temp_sd_used(i, j) = S[0]; // ensure correct SD reporting
+    }
 
-      // interpolate temperature standard deviation time series
-      if (m_sd_file_set) {
-        m_air_temp_sd->interp(i, j, S);
-      } else {
-        double tmp = (*m_air_temp_sd)(i, j);
-        for (int k = 0; k < N; ++k) {
-          S[k] = tmp;
+    if (fausto_greve) {
+      // we have been asked to set mass balance parameters according to
+      //   formula (6) in [\ref Faustoetal2009]; they overwrite ddf set above
+      ddf = fausto_greve->degree_day_factors(i, j, (*latitude)(i, j));
+    }
+
+    return true;
+  };
+
+  // Uses degree-day factors, the number of PDDs, and the snow precipitation to get surface
+  // mass balance (and diagnostics: accumulation, melt, runoff) at (i, j).
+  auto balance = [&](int i, int j, const LocalMassBalance::DegreeDayFactors &factors,
+                     const double *PDDs, const double *snow) {
+    double next_snow_depth_reset = m_next_balance_year_start;
+
+    // make copies of firn and snow depth values at this point to avoid accessing 2D
+    // fields in the inner loop
+    double
+      ice         = H(i, j),
+      firn_depth  = m_firn_depth(i, j),
+      snow_depth  = m_snow_depth(i, j);
+
+    // accumulation, melt, runoff over this time-step
+    double
+      A   = 0.0,
+      M   = 0.0,
+      R   = 0.0,
+      SMB = 0.0;
+
+    for (int k = 0; k < N; ++k) {
+      if (ts[k] >= next_snow_depth_reset) {
+        snow_depth = 0.0;
+        while (next_snow_depth_reset <= ts[k]) {
+          next_snow_depth_reset = m_grid->ctx()->time()->increment_date(next_snow_depth_reset, 1);
         }
       }
 
-      if (fausto_greve) {
-        // we have been asked to set mass balance parameters according to
-        //   formula (6) in [\ref Faustoetal2009]; they overwrite ddf set above
-        ddf = fausto_greve->degree_day_factors(i, j, (*latitude)(i, j));
+      const double accumulation = snow[k] * dtseries;
+
+      LocalMassBalance::Changes changes;
+      changes = m_mbscheme->step(factors, PDDs[k],
+                                 ice, firn_depth, snow_depth, accumulation);
+
+      // update ice thickness
+      ice += changes.smb;
+      assert(ice >= 0);
+
+      // update firn depth
+      firn_depth += changes.firn_depth;
+      assert(firn_depth >= 0);
+
+      // update snow depth
+      snow_depth += changes.snow_depth;
+      assert(snow_depth >= 0);
+
+      // update total accumulation, melt, and runoff
+      {
+        A   += accumulation;
+        M   += changes.melt;
+        R   += changes.runoff;
+        SMB += changes.smb;
       }
+    } // end of the time-stepping loop
+
+    // set firn and snow depths
+    m_firn_depth(i, j) = firn_depth;
+    m_snow_depth(i, j) = snow_depth;
+
+    // set total accumulation, melt, and runoff, and SMB at this point, converting
+    // from "meters, ice equivalent" to "kg / m^2"
+    {
+      (*m_accumulation)(i, j)          = A * ice_density;
+      (*m_melt)(i, j)                  = M * ice_density;
+      (*m_runoff)(i, j)                = R * ice_density;
+      // m_mass_flux (unlike m_accumulation, m_melt, and m_runoff), is a
+      // rate. m * (kg / m^3) / second = kg / m^2 / second
+      m_mass_flux(i, j) = SMB * ice_density / dt;
+    }
+  };
+
+  ParallelSection loop(m_grid->com);
+  try {
+    if (m_elevation_classes) {
+      // Inputs are collected at all points in a block of grid cells, grouped into classes
+      // according to the surface elevation and averaged. PDDs and snow accumulation are
+      // computed once per class and then interpolated (linearly in elevation) to grid
+      // points.
+      //
+      // Blocks are aligned with the global grid. Processes owning parts of a block exchange
+      // partial class sums, so class averages do not depend on the domain decomposition.
+      const IceModelVec2S &surface_elevation = geometry.ice_surface_elevation;
+
+      const int
+        xs          = m_grid->xs(),
+        xm          = m_grid->xm(),
+        ys          = m_grid->ys(),
+        ym          = m_grid->ym(),
+        b           = m_elevation_classes_block_size,
+        n_blocks_x  = (m_grid->Mx() - 1) / b + 1,
+        rank        = m_grid->rank(),
+        // number of cells, sum of surface elevations, and sums of T, S, and P time series
+        record_size = 2 + 3 * N;
+
+      // Inputs collected in the part of a block owned by this process.
+      struct Block {
+        // class sums (bin index -> sums); classes are sorted by elevation
+        std::map<int, std::vector<double> > sums;
+        // points that need a mass balance computation
+        std::vector<int> cell_i, cell_j;
+        std::vector<double> cell_z;
+        std::vector<LocalMassBalance::DegreeDayFactors> cell_ddf;
+      };
+
+      // Collects inputs at points of the block starting at (i0, j0) owned by this process.
+      auto collect_block = [&](int i0, int j0, Block &block) {
+        block.sums.clear();
+        block.cell_i.clear();
+        block.cell_j.clear();
+        block.cell_z.clear();
+        block.cell_ddf.clear();
+
+        const int
+          i_start = std::max(i0, xs),
+          i_end   = std::min(i0 + b, xs + xm),
+          j_start = std::max(j0, ys),
+          j_end   = std::min(j0 + b, ys + ym);
+
+        for (int j = j_start; j < j_end; ++j) {
+          for (int i = i_start; i < i_end; ++i) {
+            if (not collect(i, j)) {
+              continue;
+            }
+
+            double z = surface_elevation(i, j);
+
+            block.cell_i.push_back(i);
+            block.cell_j.push_back(j);
+            block.cell_z.push_back(z);
+            block.cell_ddf.push_back(ddf);
+
+            auto &s = block.sums[(int)floor(z / m_elevation_classes_bin_width)];
+            if (s.empty()) {
+              s.assign(record_size, 0.0);
+            }
+
+            s[0] += 1.0;
+            s[1] += z;
+            for (int k = 0; k < N; ++k) {
+              s[2 + k]         += T[k];
+              s[2 + N + k]     += S[k];
+              s[2 + 2 * N + k] += P[k];
+            }
+          }
+        }
+      };
+
+      // Inputs in blocks shared with other processes (block index -> inputs). These are
+      // collected before the exchange and kept for the mass balance computation.
+      std::map<int, Block> shared;
 
-      // apply standard deviation lapse rate on top of prescribed values
-      if (sigmalapserate != 0.0) {
-        double lat = (*latitude)(i, j);
-        for (int k = 0; k < N; ++k) {
-          S[k] += sigmalapserate * (lat - sigmabaselat);
+      // Partial class sums in blocks shared with other processes (rank -> a sequence of
+      // block index, bin index, class sums).
+      std::map<int, std::vector<double> > send_buffer, recv_buffer;
+      {
+        ParallelSection section(m_grid->com);
+        try {
+          for (const auto &s : m_shared_blocks) {
+            const int block = s.first;
+
+            auto &inputs = shared[block];
+            collect_block((block % n_blocks_x) * b, (block / n_blocks_x) * b, inputs);
+
+            for (int r : s.second) {
+              if (r == rank) {
+                continue;
+              }
+              // note: this creates a (possibly empty) message for every process sharing
+              // a block with this one
+              auto &buffer = send_buffer[r];
+              for (const auto &c : inputs.sums) {
+                buffer.push_back(block);
+                buffer.push_back(c.first);
+                buffer.insert(buffer.end(), c.second.begin(), c.second.end());
+              }
+            }
+          }
+        } catch (...) {
+          section.failed();
         }
-        (*m_air_temp_sd)(i, j) = S[0]; // ensure correct SD reporting
+        section.check();
       }
 
-      // apply standard deviation param over ice if in use
-      if (m_sd_use_param and mask.icy(i, j)) {
-        for (int k = 0; k < N; ++k) {
-          S[k] = m_sd_param_a * (T[k] - 273.15) + m_sd_param_b;
-          if (S[k] < 0.0) {
-            S[k] = 0.0 ;
-          }
+      // Exchange partial sums. Sharing blocks is symmetric, so this process receives one
+      // message from each process it sends one to.
+      {
+        std::map<int, int> send_size, recv_size;
+        for (const auto &m : send_buffer) {
+          send_size[m.first] = m.second.size();
+          recv_size[m.first] = 0;
         }
-        (*m_air_temp_sd)(i, j) = S[0]; // ensure correct SD reporting
+
+        std::vector<MPI_Request> requests;
+        requests.reserve(2 * send_buffer.size());
+
+        for (const auto &m : send_buffer) {
+          const int r = m.first;
+          requests.emplace_back();
+          MPI_Isend(&send_size[r], 1, MPI_INT, r, 0, m_grid->com, &requests.back());
+          requests.emplace_back();
+          MPI_Irecv(&recv_size[r], 1, MPI_INT, r, 0, m_grid->com, &requests.back());
+        }
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+        requests.clear();
+
+        for (auto &m : send_buffer) {
+          const int r = m.first;
+          auto &buffer = recv_buffer[r];
+          buffer.resize(recv_size[r]);
+
+          requests.emplace_back();
+          MPI_Isend(m.second.data(), m.second.size(), MPI_DOUBLE, r, 1, m_grid->com,
+                    &requests.back());
+          requests.emplace_back();
+          MPI_Irecv(buffer.data(), buffer.size(), MPI_DOUBLE, r, 1, m_grid->com,
+                    &requests.back());
+        }
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
       }
 
-      // Use temperature time series, the "positive" threshhold, and
-      // the standard deviation of the daily variability to get the
-      // number of positive degree days (PDDs)
-      if (mask.ice_free_ocean(i, j)) {
-        for (int k = 0; k < N; ++k) {
-          PDDs[k] = 0.0;
+      // class sums computed by other processes (block index -> rank -> bin index -> sums)
+      std::map<int, std::map<int, std::map<int, std::vector<double> > > > remote_sums;
+      for (const auto &m : recv_buffer) {
+        const auto &buffer = m.second;
+        for (size_t n = 0; n + 2 + record_size <= buffer.size(); n += 2 + record_size) {
+          const int
+            block = buffer[n],
+            bin   = buffer[n + 1];
+
+          remote_sums[block][m.first][bin].assign(buffer.begin() + n + 2,
+                                                  buffer.begin() + n + 2 + record_size);
         }
-      } else {
-        m_mbscheme->get_PDDs(dtseries, S, T, // inputs
-                             PDDs);          // output
       }
 
-      // Use temperature time series to remove rainfall from precipitation
-      m_mbscheme->get_snow_accumulation(T,  // air temperature (input)
-                                        P); // precipitation rate (input-output)
+      // inputs in a block owned by this process only
+      Block local;
 
-      // Use degree-day factors, the number of PDDs, and the snow precipitation to get surface mass
-      // balance (and diagnostics: accumulation, melt, runoff)
-      {
-        double next_snow_depth_reset = m_next_balance_year_start;
-
-        // make copies of firn and snow depth values at this point to avoid accessing 2D
-        // fields in the inner loop
-        double
-          ice  = H(i, j),
-          firn = m_firn_depth(i, j),
-          snow = m_snow_depth(i, j);
-
-        // accumulation, melt, runoff over this time-step
-        double
-          A   = 0.0,
-          M   = 0.0,
-          R   = 0.0,
-          SMB = 0.0;
-
-        for (int k = 0; k < N; ++k) {
-          if (ts[k] >= next_snow_depth_reset) {
-            snow = 0.0;
-            while (next_snow_depth_reset <= ts[k]) {
-              next_snow_depth_reset = m_grid->ctx()->time()->increment_date(next_snow_depth_reset, 1);
+      // class sums in a shared block
+      std::map<int, std::vector<double> > block_sums;
+
+      // class averages
+      std::vector<double> T_class, S_class, P_class, PDD_class, z_class;
+
+      // PDDs and snow accumulation at a point
+      std::vector<double> PDDs(N), snow(N);
+
+      // blocks intersecting the sub-domain of this process start at (i_first + m * b,
+      // j_first + n * b)
+      const int
+        i_first = (xs / b) * b,
+        j_first = (ys / b) * b;
+
+      for (int j0 = j_first; j0 < ys + ym; j0 += b) {
+        for (int i0 = i_first; i0 < xs + xm; i0 += b) {
+          const int block = (j0 / b) * n_blocks_x + i0 / b;
+
+          auto owners = m_shared_blocks.find(block);
+
+          const Block *inputs = &local;
+          if (owners == m_shared_blocks.end()) {
+            collect_block(i0, j0, local);
+          } else {
+            inputs = &shared[block];
+          }
+
+          if (inputs->cell_i.empty()) {
+            continue;
+          }
+
+          const std::map<int, std::vector<double> > *class_sums = &inputs->sums;
+
+          if (owners != m_shared_blocks.end()) {
+            // add partial sums in the order of ranks so that all processes sharing this
+            // block get the same class averages
+            block_sums.clear();
+            for (int r : owners->second) {
+              const auto &partial = r == rank ? inputs->sums : remote_sums[block][r];
+              for (const auto &s : partial) {
+                auto &total = block_sums[s.first];
+                if (total.empty()) {
+                  total.assign(record_size, 0.0);
+                }
+                for (int k = 0; k < record_size; ++k) {
+                  total[k] += s.second[k];
+                }
+              }
             }
+            class_sums = &block_sums;
           }
 
-          const double accumulation = P[k] * dtseries;
+          // compute class averages of inputs and of the surface elevation
+          const int n_classes = class_sums->size();
 
-          LocalMassBalance::Changes changes;
-          changes = m_mbscheme->step(ddf, PDDs[k],
-                                     ice, firn, snow, accumulation);
+          T_class.resize(n_classes * N);
+          S_class.resize(n_classes * N);
+          P_class.resize(n_classes * N);
+          z_class.resize(n_classes);
 
-          // update ice thickness
-          ice += changes.smb;
-          assert(ice >= 0);
+          // bin index -> class index
+          std::map<int, int> classes;
+          {
+            int c = 0;
+            for (const auto &s : *class_sums) {
+              const double w = 1.0 / s.second[0];
+
+              classes[s.first] = c;
+
+              z_class[c] = s.second[1] * w;
+              for (int k = 0; k < N; ++k) {
+                T_class[c * N + k] = s.second[2 + k] * w;
+                S_class[c * N + k] = s.second[2 + N + k] * w;
+                P_class[c * N + k] = s.second[2 + 2 * N + k] * w;
+              }
+              ++c;
+            }
+          }
 
-          // update firn depth
-          firn += changes.firn_depth;
-          assert(firn >= 0);
+          PDD_class.resize(T_class.size());
+          m_mbscheme->get_PDDs(dtseries, S_class, T_class, PDD_class);
+          m_mbscheme->get_snow_accumulation(T_class, P_class);
 
-          // update snow depth
-          snow += changes.snow_depth;
-          assert(snow >= 0);
+          // interpolate to grid points and compute the mass balance
+          for (size_t n = 0; n < inputs->cell_i.size(); ++n) {
+            const double z = inputs->cell_z[n];
 
-          // update total accumulation, melt, and runoff
-          {
-            A   += accumulation;
-            M   += changes.melt;
-            R   += changes.runoff;
-            SMB += changes.smb;
+            // find classes bracketing the elevation at this point
+            int c0 = classes[(int)floor(z / m_elevation_classes_bin_width)], c1 = c0;
+            if (z >= z_class[c0] and c0 + 1 < n_classes) {
+              c1 = c0 + 1;
+            } else if (z < z_class[c0] and c0 > 0) {
+              c0 = c0 - 1;
+            }
+
+            double lambda = 0.0;
+            if (c1 != c0) {
+              lambda = (z - z_class[c0]) / (z_class[c1] - z_class[c0]);
+            }
+
+            for (int k = 0; k < N; ++k) {
+              PDDs[k] = (1.0 - lambda) * PDD_class[c0 * N + k] + lambda * PDD_class[c1 * N + k];
+              snow[k] = (1.0 - lambda) * P_class[c0 * N + k] + lambda * P_class[c1 * N + k];
+            }
+
+            balance(inputs->cell_i[n], inputs->cell_j[n], inputs->cell_ddf[n],
+                    PDDs.data(), snow.data());
           }
-        } // end of the time-stepping loop
-
-        // set firn and snow depths
-        m_firn_depth(i, j) = firn;
-        m_snow_depth(i, j) = snow;
-
-        // set total accumulation, melt, and runoff, and SMB at this point, converting
-        // from "meters, ice equivalent" to "kg / m^2"
-        {
-          (*m_accumulation)(i, j)          = A * ice_density;
-          (*m_melt)(i, j)                  = M * ice_density;
-          (*m_runoff)(i, j)                = R * ice_density;
-          // m_mass_flux (unlike m_accumulation, m_melt, and m_runoff), is a
-          // rate. m * (kg / m^3) / second = kg / m^2 / second
-          m_mass_flux(i, j) = SMB * ice_density / dt;
         }
       }
+    } else {
+      // Time series of the points in a row of the sub-domain that need a mass balance
+      // computation (i.e. all points except for ice-free ocean) are stored one after
+      // another in these "tile" arrays. This way PDDs and snow accumulation are computed
+      // using one pass over contiguous arrays per row instead of a pair of short loops per
+      // grid point.
+      const int
+        xs = m_grid->xs(),
+        xm = m_grid->xm(),
+        ys = m_grid->ys(),
+        ym = m_grid->ym();
+
+      std::vector<double> T_tile, S_tile, P_tile, PDD_tile;
+      T_tile.reserve(xm * N);
+      S_tile.reserve(xm * N);
+      P_tile.reserve(xm * N);
+      PDD_tile.reserve(xm * N);
+
+      // i indexes and degree day factors of points in a tile
+      std::vector<int> tile_i;
+      std::vector<LocalMassBalance::DegreeDayFactors> tile_ddf;
+      tile_i.reserve(xm);
+      tile_ddf.reserve(xm);
+
+      for (int j = ys; j < ys + ym; ++j) {
+        T_tile.clear();
+        S_tile.clear();
+        P_tile.clear();
+        tile_i.clear();
+        tile_ddf.clear();
+
+        // collect inputs
+        for (int i = xs; i < xs + xm; ++i) {
+          if (not collect(i, j)) {
+            continue;
+          }
+
+          tile_i.push_back(i);
+          tile_ddf.push_back(ddf);
+          T_tile.insert(T_tile.end(), T.begin(), T.end());
+          S_tile.insert(S_tile.end(), S.begin(), S.end());
+          P_tile.insert(P_tile.end(), P.begin(), P.end());
+        }
 
-      if (mask.ice_free_ocean(i, j)) {
-        m_firn_depth(i, j) = 0.0;  // no firn in the ocean
-        m_snow_depth(i, j) = 0.0;  // snow over the ocean does not stick
+        // Use temperature time series, the "positive" threshhold, and
+        // the standard deviation of the daily variability to get the
+        // number of positive degree days (PDDs)
+        PDD_tile.resize(T_tile.size());
+        m_mbscheme->get_PDDs(dtseries, S_tile, T_tile, // inputs
+                             PDD_tile);                // output
+
+        // Use temperature time series to remove rainfall from precipitation
+        m_mbscheme->get_snow_accumulation(T_tile,  // air temperature (input)
+                                          P_tile); // precipitation rate (input-output)
+
+        for (size_t n = 0; n < tile_i.size(); ++n) {
+          balance(tile_i[n], j, tile_ddf[n], &PDD_tile[n * N], &P_tile[n * N]);
+        }
       }
     }
   } catch (...) {
@@ -486,7 +896,7 @@ const IceModelVec2S& TemperatureIndex::snow_depth() const {
 }
 
 const IceModelVec2S& TemperatureIndex::air_temp_sd() const {
-  return *m_air_temp_sd;
+  return m_air_temp_sd_used;
 }
 
 void TemperatureIndex::define_model_state_impl(const File &output) const {
@@ -774,7 +1184,7 @@ DiagnosticList TemperatureIndex::diagnostics_impl() const {
     {"surface_melt_rate",         Diagnostic::Ptr(new SurfaceMelt(this, MASS))},
     {"surface_runoff_flux",       Diagnostic::Ptr(new SurfaceRunoff(this, AMOUNT))},
     {"surface_runoff_rate",       Diagnostic::Ptr(new SurfaceRunoff(this, MASS))},
-    {"air_temp_sd",               Diagnostic::wrap(*m_air_temp_sd)},
+    {"air_temp_sd",               Diagnostic::wrap(m_air_temp_sd_used)},
     {"snow_depth",                Diagnostic::wrap(m_snow_depth)},
     {"firn_depth",                Diagnostic::wrap(m_firn_depth)},
   };
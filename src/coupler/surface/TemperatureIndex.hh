@@ -20,6 +20,8 @@
 #define _PSTEMPERATUREINDEX_H_
 
 #include <memory>
+#include <map>
+#include <vector>
 
 #include "pism/util/iceModelVec2T.hh"
 #include "pism/coupler/SurfaceModel.hh"
@@ -97,6 +99,10 @@ protected:
   //! standard deviation of the daily variability of the air temperature
   IceModelVec2T::Ptr m_air_temp_sd;
 
+  //! standard deviation used during the last time step (after lapse rate and
+  //! parameterization adjustments), for reporting
+  IceModelVec2S m_air_temp_sd_used;
+
   //! total accumulation during the last time step
   IceModelVec2S::Ptr m_accumulation;
 
@@ -106,6 +112,16 @@ protected:
   //! total runoff during the last time step
   IceModelVec2S::Ptr m_runoff;
 
+  //! true if PDDs and snow accumulation are computed using elevation classes
+  bool m_elevation_classes;
+  //! width of elevation classes, in meters
+  double m_elevation_classes_bin_width;
+  //! size of square blocks of grid cells sharing a set of elevation classes
+  int m_elevation_classes_block_size;
+  //! blocks shared with other processes (block index -> ranks of processes owning parts
+  //! of the block, in ascending order)
+  std::map<int, std::vector<int> > m_shared_blocks;
+
   bool m_sd_use_param, m_sd_file_set;
   int m_sd_period;
   double m_sd_param_a, m_sd_param_b;
@@ -358,9 +358,7 @@ void PDDrandMassBalance::get_PDDs(double dt_series,
     // average temperature in k-th interval
     double T_k = T[k] + gsl_ran_gaussian(pddRandGen, S[k]); // add random: N(0,sigma)
 
-    if (T_k > pdd_threshold_temp) {
-      PDDs[k] = h_days * (T_k - pdd_threshold_temp);
-    }
+    PDDs[k] = h_days * std::max(T_k - pdd_threshold_temp, 0.0);
   }
 }
 
@@ -78,13 +78,16 @@ public:
 
   //! Count positive degree days (PDDs).  Returned value in units of K day.
   /*! Inputs T[0],...,T[N-1] are temperatures (K) at times t, t+dt_series, ..., t+(N-1)dt_series.
-    Inputs `t`, `dt_series` are in seconds.  */
+    Inputs `t`, `dt_series` are in seconds.
+
+    Computations are element-wise, so arrays may contain time series at several grid
+    points stored one after another. */
   virtual void get_PDDs(double dt_series,
                         const std::vector<double> &S,
                         const std::vector<double> &T,
                         std::vector<double> &PDDs) = 0;
 
-  /*! Remove rain from precipitation. */
+  /*! Remove rain from precipitation (element-wise; see get_PDDs()). */
   virtual void get_snow_accumulation(const std::vector<double> &T,
                                      std::vector<double> &precip_rate) = 0;
 
@@ -17,9 +17,10 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
-#include <cmath>                // fabs
+#include <cmath>                // fabs, exp
+#include <cassert>
 
-#include "pism/util/iceModelVec.hh"
+#include "lapse_rates.hh"
 
 namespace pism {
 
@@ -42,4 +43,90 @@ void lapse_rate_correction(const IceModelVec2S &surface,
   }
 }
 
+ElevationChangeCache::ElevationChangeCache(IceGrid::ConstPtr grid, double tolerance)
+  : m_tolerance(tolerance),
+    m_scaling(false),
+    m_temperature_lapse_rate(0.0),
+    m_exp_factor(0.0),
+    m_surface(grid, "surface_elevation", WITHOUT_GHOSTS),
+    m_elevation_change(grid, "elevation_change", WITHOUT_GHOSTS),
+    m_scaling_factor(grid, "scaling_factor", WITHOUT_GHOSTS),
+    m_reference_surface(NULL),
+    m_reference_surface_counter(-1) {
+  // empty
+}
+
+//! Store scaling factors used by scale().
+void ElevationChangeCache::enable_scaling(double temperature_lapse_rate, double exp_factor) {
+  m_scaling                = true;
+  m_temperature_lapse_rate = temperature_lapse_rate;
+  m_exp_factor             = exp_factor;
+
+  // force re-computation
+  m_reference_surface = NULL;
+}
+
+void ElevationChangeCache::update(const IceModelVec2S &surface,
+                                  const IceModelVec2S &reference_surface) {
+  IceGrid::ConstPtr grid = m_surface.grid();
+
+  // re-compute everywhere if the reference surface changed
+  const bool everywhere = (&reference_surface != m_reference_surface or
+                           reference_surface.state_counter() != m_reference_surface_counter);
+
+  IceModelVec::AccessList list{&surface, &reference_surface,
+                               &m_surface, &m_elevation_change};
+  if (m_scaling) {
+    list.add(m_scaling_factor);
+  }
+
+  for (Points p(*grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    if (not everywhere and fabs(surface(i, j) - m_surface(i, j)) <= m_tolerance) {
+      continue;
+    }
+
+    const double dz = surface(i, j) - reference_surface(i, j);
+
+    m_surface(i, j)          = surface(i, j);
+    m_elevation_change(i, j) = dz;
+
+    if (m_scaling) {
+      m_scaling_factor(i, j) = exp(-m_exp_factor * m_temperature_lapse_rate * dz);
+    }
+  }
+
+  m_reference_surface         = &reference_surface;
+  m_reference_surface_counter = reference_surface.state_counter();
+}
+
+//! Apply the lapse rate correction: `result -= lapse_rate * (surface - reference_surface)`.
+void ElevationChangeCache::shift(double lapse_rate, IceModelVec2S &result) const {
+  if (fabs(lapse_rate) < 1e-12) {
+    return;
+  }
+
+  IceModelVec::AccessList list{&m_elevation_change, &result};
+
+  for (Points p(*result.grid()); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    result(i, j) -= lapse_rate * m_elevation_change(i, j);
+  }
+}
+
+//! Scale `result` using stored scaling factors (see enable_scaling()).
+void ElevationChangeCache::scale(IceModelVec2S &result) const {
+  assert(m_scaling);
+
+  IceModelVec::AccessList list{&m_scaling_factor, &result};
+
+  for (Points p(*result.grid()); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    result(i, j) *= m_scaling_factor(i, j);
+  }
+}
+
 } // end of namespace pism
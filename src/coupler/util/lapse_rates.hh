@@ -20,15 +20,53 @@
 #ifndef LAPSE_RATES_H
 #define LAPSE_RATES_H
 
-namespace pism {
+#include "pism/util/iceModelVec.hh"
 
-class IceModelVec2S;
+namespace pism {
 
 void lapse_rate_correction(const IceModelVec2S &surface,
                            const IceModelVec2S &reference_surface,
                            double lapse_rate,
                            IceModelVec2S &result);
 
+//! Elevation change relative to a reference surface, updated incrementally.
+/*!
+ * Stores `surface - reference_surface` (and, optionally, the scaling factor
+ * `exp(exp_factor * temperature_lapse_rate * (reference_surface - surface))`).
+ *
+ * These fields are re-computed everywhere if the reference surface changed (according to
+ * its state counter) and only at points where the surface elevation changed by more than
+ * `tolerance` otherwise.
+ */
+class ElevationChangeCache {
+public:
+  ElevationChangeCache(IceGrid::ConstPtr grid, double tolerance);
+
+  void enable_scaling(double temperature_lapse_rate, double exp_factor);
+
+  void update(const IceModelVec2S &surface, const IceModelVec2S &reference_surface);
+
+  void shift(double lapse_rate, IceModelVec2S &result) const;
+  void scale(IceModelVec2S &result) const;
+private:
+  double m_tolerance;
+
+  bool m_scaling;
+  double m_temperature_lapse_rate;
+  double m_exp_factor;
+
+  //! surface elevation used to compute m_elevation_change
+  IceModelVec2S m_surface;
+  //! surface elevation minus reference surface elevation
+  IceModelVec2S m_elevation_change;
+  //! scaling factor
+  IceModelVec2S m_scaling_factor;
+
+  //! reference surface and its state counter used to compute stored fields
+  const IceModelVec2S *m_reference_surface;
+  int m_reference_surface_counter;
+};
+
 } // end of namespace pism
 
 #endif /* LAPSE_RATES_H */
@@ -321,7 +321,9 @@ MaxTimestep EnergyModel::max_timestep_impl(double t) const {
                                   " Cannot compute max. time step.");
   }
 
-  return MaxTimestep(m_stress_balance->max_timestep_cfl_3d().dt_max.value(), "energy");
+  MaxTimestep dt = m_stress_balance->max_timestep_cfl_3d().dt_max;
+
+  return MaxTimestep(dt.value(), "energy", dt.i(), dt.j());
 }
 
 const std::string& EnergyModel::stdout_flags() const {
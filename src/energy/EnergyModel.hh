@@ -23,6 +23,7 @@
 #include "pism/util/Component.hh"
 
 #include "pism/util/iceModelVec.hh"
+#include "pism/util/ActiveColumns.hh"
 
 namespace pism {
 
@@ -140,6 +141,9 @@ protected:
   IceModelVec3 m_work;
   IceModelVec2S m_basal_melt_rate;
 
+  //! Lists of icy and ice-free columns.
+  ActiveColumns m_active_columns;
+
   EnergyModelStats m_stats;
 
 private:
@@ -154,9 +154,26 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
 
   unsigned int liquifiedCount = 0;
 
+  m_active_columns.update(ice_thickness, &cell_type);
+
   ParallelSection loop(m_grid->com);
   try {
-    for (Points pt(*m_grid); pt; pt.next()) {
+    // deal completely with columns with no ice; enthalpy and basal_melt_rate need setting
+    {
+      const double p_surface = EC->pressure(0.0); // FIXME issue #15
+
+      for (ColumnPoints pt(m_active_columns.ice_free()); pt; pt.next()) {
+        const int i = pt.i(), j = pt.j();
+
+        m_work.set_column(i, j, EC->enthalpy_permissive(ice_surface_temp(i, j),
+                                                        surface_liquid_fraction(i, j),
+                                                        p_surface));
+        // There is no basal melt rate on ice free land and ice free ocean
+        m_basal_melt_rate(i, j) = 0.0;
+      }
+    }
+
+    for (ColumnPoints pt(m_active_columns.icy()); pt; pt.next()) {
       const int i = pt.i(), j = pt.j();
 
       const double H = ice_thickness(i, j);
@@ -175,7 +192,8 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
 
       const bool ice_free_column = (system.ks() == 0);
 
-      // deal completely with columns with no ice; enthalpy and basal_melt_rate need setting
+      // deal completely with columns with ice that is too thin to resolve; enthalpy and
+      // basal_melt_rate need setting
       if (ice_free_column) {
         m_work.set_column(i, j, Enth_ks);
         // The floating basal melt rate will be set later; cover this
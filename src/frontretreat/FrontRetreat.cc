@@ -90,6 +90,10 @@ MaxTimestep FrontRetreat::max_timestep(const IceModelVec2CellType &cell_type,
     retreat_rate_max  = 0.0,
     retreat_rate_mean = 0.0;
   int N_cells = 0;
+  // linear index of the location of the maximum retreat rate
+  int max_index = -1;
+
+  const int Mx = grid->Mx();
 
   IceModelVec::AccessList list{&cell_type, &bc_mask, &retreat_rate};
 
@@ -105,13 +109,16 @@ MaxTimestep FrontRetreat::max_timestep(const IceModelVec2CellType &cell_type,
 
       N_cells           += 1;
       retreat_rate_mean += C;
-      retreat_rate_max   = std::max(C, retreat_rate_max);
+      if (C > retreat_rate_max) {
+        retreat_rate_max = C;
+        max_index        = j * Mx + i;
+      }
     }
   }
 
   N_cells           = GlobalSum(grid->com, N_cells);
   retreat_rate_mean = GlobalSum(grid->com, retreat_rate_mean);
-  retreat_rate_max  = GlobalMax(grid->com, retreat_rate_max);
+  GlobalMaxLoc(grid->com, retreat_rate_max, max_index, retreat_rate_max, max_index);
 
   if (N_cells > 0.0) {
     retreat_rate_mean /= N_cells;
@@ -132,6 +139,10 @@ MaxTimestep FrontRetreat::max_timestep(const IceModelVec2CellType &cell_type,
                  convert(m_sys, retreat_rate_mean, "m second-1", "m year-1"),
                  N_cells);
 
+  if (max_index >= 0) {
+    return MaxTimestep(std::max(dt, dt_min), "front_retreat", max_index % Mx, max_index / Mx);
+  }
+
   return MaxTimestep(std::max(dt, dt_min), "front_retreat");
 }
 
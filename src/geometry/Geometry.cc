@@ -172,6 +172,11 @@ void Geometry::ensure_consistency(double ice_free_thickness_threshold) {
   cell_type.update_ghosts();
   ice_surface_elevation.update_ghosts();
 
+  // Values were modified point-wise above: mark these fields as modified (see
+  // ActiveColumns).
+  ice_thickness.inc_state_counter();
+  cell_type.inc_state_counter();
+
   const double
     ice_density = config->get_number("constants.ice.density"),
     ocean_density = config->get_number("constants.sea_water.density");
@@ -27,6 +27,9 @@
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/Logger.hh"
 #include "pism/util/Profiling.hh"
+#include "pism/util/MaxTimestep.hh"
+#include "pism/util/petscwrappers/KSP.hh"
+#include "pism/util/petscwrappers/Mat.hh"
 
 namespace pism {
 
@@ -36,6 +39,7 @@ using mask::ice_free;
 using mask::ice_free_land;
 using mask::ice_free_ocean;
 using mask::icy;
+using mask::ocean;
 
 struct GeometryEvolution::Impl {
   Impl(IceGrid::ConstPtr g);
@@ -84,6 +88,23 @@ struct GeometryEvolution::Impl {
   IceModelVec2S        residual;             // ghosted; temporary storage
   IceModelVec2S        thickness;            // ghosted; temporary storage
   IceModelVec2Int      velocity_bc_mask;
+
+  //! True if the diffusive (SIA) part of the flux is treated semi-implicitly.
+  bool semi_implicit;
+
+  //! Maximum thickness change allowed during one step of the semi-implicit scheme.
+  double max_thickness_change;
+
+  //! Maximum rate of thickness change due to flow during the last time step (m/s).
+  double max_thickness_change_rate;
+
+  // Semi-implicit mass transport
+  IceModelVec2Stag     implicit_flux;        // ghosted; diffusive flux computed implicitly
+  IceModelVec2S        rhs;                  // right hand side of the linear system
+  IceModelVec2S        solution;             // solution of the linear system
+  petsc::DM::Ptr       da;                   // dof=1 DA used by the KSP solver
+  petsc::KSP           KSP;
+  petsc::Mat           A;
 };
 
 GeometryEvolution::Impl::Impl(IceGrid::ConstPtr grid)
@@ -105,7 +126,10 @@ GeometryEvolution::Impl::Impl(IceGrid::ConstPtr grid)
     cell_type(grid, "cell_type", WITH_GHOSTS),
     residual(grid, "residual", WITH_GHOSTS),
     thickness(grid, "thickness", WITH_GHOSTS),
-    velocity_bc_mask(grid, "velocity_bc_mask", WITH_GHOSTS) {
+    velocity_bc_mask(grid, "velocity_bc_mask", WITH_GHOSTS),
+    implicit_flux(grid, "implicit_diffusive_flux", WITH_GHOSTS),
+    rhs(grid, "mass_transport_rhs", WITHOUT_GHOSTS),
+    solution(grid, "mass_transport_solution", WITHOUT_GHOSTS) {
 
   Config::ConstPtr config = grid->ctx()->config();
 
@@ -116,6 +140,11 @@ GeometryEvolution::Impl::Impl(IceGrid::ConstPtr grid)
     ice_density   = config->get_number("constants.ice.density");
     use_bmr       = config->get_flag("geometry.update.use_basal_melt_rate");
     use_part_grid = config->get_flag("geometry.part_grid.enabled");
+
+    semi_implicit        = config->get_flag("geometry.update.semi_implicit.enabled");
+    max_thickness_change = config->get_number("geometry.update.semi_implicit.max_thickness_change");
+
+    max_thickness_change_rate = 0.0;
   }
 
   // reported quantities
@@ -178,6 +207,43 @@ GeometryEvolution::Impl::Impl(IceGrid::ConstPtr grid)
     velocity_bc_mask.set_attrs("internal", "ghosted copy of the velocity B.C. mask"
                                " (1 at velocity B.C. location, 0 elsewhere)",
                                "", "", "", 0);
+
+    implicit_flux.set_attrs("internal", "diffusive (SIA) flux computed using the"
+                            " semi-implicit scheme",
+                            "m2 s-1", "m2 s-1", "", 0);
+
+    rhs.set_attrs("internal", "right hand side of the semi-implicit mass transport system",
+                  "meters", "meters", "", 0);
+
+    solution.set_attrs("internal", "ice thickness computed by the semi-implicit"
+                       " mass transport scheme",
+                       "meters", "meters", "", 0);
+  }
+
+  // PETSc objects used by the semi-implicit scheme
+  if (semi_implicit) {
+    PetscErrorCode ierr;
+
+    da = solution.dm();
+
+    ierr = DMSetMatType(*da, MATAIJ);
+    PISM_CHK(ierr, "DMSetMatType");
+
+    ierr = DMCreateMatrix(*da, A.rawptr());
+    PISM_CHK(ierr, "DMCreateMatrix");
+
+    ierr = KSPCreate(grid->com, KSP.rawptr());
+    PISM_CHK(ierr, "KSPCreate");
+
+    ierr = KSPSetOptionsPrefix(KSP, "mass_transport_");
+    PISM_CHK(ierr, "KSPSetOptionsPrefix");
+
+    // The solution from the previous time step is a good initial guess.
+    ierr = KSPSetInitialGuessNonzero(KSP, PETSC_TRUE);
+    PISM_CHK(ierr, "KSPSetInitialGuessNonzero");
+
+    ierr = KSPSetFromOptions(KSP);
+    PISM_CHK(ierr, "KSPSetFromOptions");
   }
 }
 
@@ -197,6 +263,55 @@ void GeometryEvolution::init(const InputOptions &opts) {
 void GeometryEvolution::init_impl(const InputOptions &opts) {
   (void) opts;
   // empty: the default implementation has no state
+
+  if (m_impl->semi_implicit) {
+    m_log->message(2,
+                   "* Using the semi-implicit scheme for the diffusive (SIA) part of mass transport\n"
+                   "  (max. thickness change per time step: %.1f m)...\n",
+                   m_impl->max_thickness_change);
+  }
+}
+
+/*!
+ * Time step restriction of the semi-implicit mass transport scheme.
+ *
+ * The scheme is unconditionally stable, so we limit the time step to keep the maximum
+ * thickness change per step (estimated using the rate of change during the previous step
+ * or, before the first step, by estimate_thickness_change_rate()) below
+ * `geometry.update.semi_implicit.max_thickness_change`.
+ */
+MaxTimestep GeometryEvolution::max_timestep_impl(double t) const {
+  (void) t;
+
+  if (m_impl->semi_implicit and m_impl->max_thickness_change_rate > 0.0) {
+    return MaxTimestep(m_impl->max_thickness_change / m_impl->max_thickness_change_rate,
+                       "thickness change");
+  }
+
+  return MaxTimestep("thickness change");
+}
+
+/*!
+ * Estimate the rate of thickness change using the current diffusive flux if it is not
+ * known from the previous time step.
+ *
+ * Without this the "thickness change" time step restriction would not limit the first
+ * step of the semi-implicit scheme.
+ *
+ * @param[in] diffusive_flux diffusive (SIA) flux computed using the current diffusivity
+ *                           (uses ghosts)
+ * @param[in] thickness_bc_mask ice thickness Dirichlet B.C. mask
+ */
+void GeometryEvolution::estimate_thickness_change_rate(const IceModelVec2Stag &diffusive_flux,
+                                                       const IceModelVec2Int  &thickness_bc_mask) {
+  if (not m_impl->semi_implicit or m_impl->max_thickness_change_rate > 0.0) {
+    return;
+  }
+
+  // m_impl->residual is used as temporary storage
+  compute_flux_divergence(diffusive_flux, thickness_bc_mask, m_impl->residual);
+
+  m_impl->max_thickness_change_rate = m_impl->residual.norm(NORM_INFINITY);
 }
 
 const IceModelVec2S& GeometryEvolution::flux_divergence() const {
@@ -316,6 +431,10 @@ void GeometryEvolution::flow_step(const Geometry &geometry, double dt,
                        m_impl->conservation_error);             // out
   m_impl->profile.end("ge.ensure_nonnegativity");
 
+  if (m_impl->semi_implicit and dt > 0.0) {
+    m_impl->max_thickness_change_rate = m_impl->thickness_change.norm(NORM_INFINITY) / dt;
+  }
+
   // Now the caller can compute
   //
   // H_new    = H_old + thickness_change
@@ -669,6 +788,280 @@ void GeometryEvolution::compute_flux_divergence(const IceModelVec2Stag &flux,
   loop.check();
 }
 
+/*!
+ * Return true if the diffusive flux through the interface between cells of types
+ * `current` and `neighbor` should be treated implicitly.
+ *
+ * We use the implicit treatment in grounded ice and at grounded margins not adjacent to
+ * the ocean, i.e. where the ice surface elevation is equal to `bed + thickness`.
+ */
+static bool implicit_interface(int current, int neighbor) {
+  return ((grounded_ice(current) or grounded_ice(neighbor)) and
+          not (ocean(current) or ocean(neighbor)));
+}
+
+/*!
+ * Compute the diffusive (SIA) flux using a semi-implicit (linearized backward Euler) time
+ * discretization.
+ *
+ * The diffusivity `D` is "frozen" at the beginning of the time step and we solve
+ *
+ * @f[ H^{n+1} - \Delta t\, \nabla \cdot (D \nabla (H^{n+1} + b)) = H^{n} - \Delta t\, \nabla \cdot Q_{\text{explicit}}, @f]
+ *
+ * where @f$ Q_{\text{explicit}} @f$ is the diffusive flux through interfaces that
+ * cannot be treated implicitly (see implicit_interface()). The advective part of the
+ * flux is still handled explicitly in flow_step().
+ *
+ * The flux computed using the new ice thickness is then passed to flow_step() in place of
+ * the explicit diffusive flux. This way the diffusive part of the mass transport is
+ * unconditionally stable and part-grid, boundary conditions and flux limiting are handled
+ * by the usual code.
+ *
+ * @param[in] geometry ice geometry
+ * @param[in] dt time step, seconds
+ * @param[in] diffusivity SIA diffusivity on the staggered grid (uses ghosts)
+ * @param[in] diffusive_flux explicit diffusive (SIA) flux on the staggered grid (uses ghosts)
+ * @param[in] thickness_bc_mask ice thickness Dirichlet B.C. mask
+ */
+const IceModelVec2Stag& GeometryEvolution::semi_implicit_diffusive_flux(const Geometry &geometry,
+                                                                        double dt,
+                                                                        const IceModelVec2Stag &diffusivity,
+                                                                        const IceModelVec2Stag &diffusive_flux,
+                                                                        const IceModelVec2Int  &thickness_bc_mask) {
+  if (not m_impl->semi_implicit) {
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "the semi-implicit mass transport scheme is disabled");
+  }
+
+  m_impl->profile.begin("ge.semi_implicit");
+
+  // make ghosted copies of input fields
+  {
+    m_impl->ice_thickness.copy_from(geometry.ice_thickness);
+    m_impl->sea_level.copy_from(geometry.sea_level_elevation);
+    m_impl->bed_elevation.copy_from(geometry.bed_elevation);
+
+    m_impl->gc.compute_mask(m_impl->sea_level,     // in (uses ghosts)
+                            m_impl->bed_elevation, // in (uses ghosts)
+                            m_impl->ice_thickness, // in (uses ghosts)
+                            m_impl->cell_type);    // out (ghosts are updated)
+  }
+
+  assemble_semi_implicit_system(dt,
+                                m_impl->cell_type,
+                                m_impl->ice_thickness,
+                                m_impl->bed_elevation,
+                                diffusivity,
+                                diffusive_flux,
+                                thickness_bc_mask);
+
+  // solve the system
+  {
+    PetscErrorCode ierr;
+
+    ierr = KSPSetOperators(m_impl->KSP, m_impl->A, m_impl->A);
+    PISM_CHK(ierr, "KSPSetOperators");
+
+    // use the current ice thickness as the initial guess
+    m_impl->solution.copy_from(geometry.ice_thickness);
+
+    ierr = KSPSolve(m_impl->KSP, m_impl->rhs.vec(), m_impl->solution.vec());
+    PISM_CHK(ierr, "KSPSolve");
+
+    KSPConvergedReason reason;
+    ierr = KSPGetConvergedReason(m_impl->KSP, &reason);
+    PISM_CHK(ierr, "KSPGetConvergedReason");
+
+    if (reason < 0) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "KSP iteration failed while solving the mass transport"
+                                    " equation: %s", KSPConvergedReasons[reason]);
+    }
+
+    PetscInt ksp_iterations = 0;
+    ierr = KSPGetIterationNumber(m_impl->KSP, &ksp_iterations);
+    PISM_CHK(ierr, "KSPGetIterationNumber");
+
+    m_log->message(3, "  semi-implicit mass transport: KSP converged in %d iterations\n",
+                   (int)ksp_iterations);
+  }
+
+  // compute the diffusive flux corresponding to the new ice thickness
+  {
+    IceModelVec2S &H_new = m_impl->thickness;
+    H_new.copy_from(m_impl->solution);
+
+    const IceModelVec2CellType &cell_type = m_impl->cell_type;
+    const IceModelVec2S &b = m_impl->bed_elevation;
+    const IceModelVec2Stag
+      &D = diffusivity,
+      &Q = diffusive_flux;
+    IceModelVec2Stag &result = m_impl->implicit_flux;
+
+    const int
+      Mx = m_grid->Mx(),
+      My = m_grid->My();
+
+    const double
+      dx = m_grid->dx(),
+      dy = m_grid->dy();
+
+    IceModelVec::AccessList list{&cell_type, &H_new, &b, &D, &Q, &result};
+
+    for (Points p(*m_grid); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      for (int o = 0; o < 2; ++o) {
+        const int
+          oi  = 1 - o,
+          oj  = o,
+          i_n = i + oi,
+          j_n = j + oj;
+
+        const bool inside = i_n < Mx and j_n < My;
+
+        if (inside and implicit_interface(cell_type.as_int(i, j), cell_type.as_int(i_n, j_n))) {
+          const double
+            ds = (H_new(i_n, j_n) + b(i_n, j_n)) - (H_new(i, j) + b(i, j)),
+            h  = o == 0 ? dx : dy;
+
+          result(i, j, o) = - D(i, j, o) * ds / h;
+        } else {
+          result(i, j, o) = Q(i, j, o);
+        }
+      }
+    }
+
+    result.update_ghosts();
+  }
+
+  m_impl->profile.end("ge.semi_implicit");
+
+  return m_impl->implicit_flux;
+}
+
+/*!
+ * Assemble the linear system used by the semi-implicit mass transport scheme.
+ *
+ * See semi_implicit_diffusive_flux() for details.
+ */
+void GeometryEvolution::assemble_semi_implicit_system(double dt,
+                                                      const IceModelVec2CellType &cell_type,
+                                                      const IceModelVec2S &ice_thickness,
+                                                      const IceModelVec2S &bed_elevation,
+                                                      const IceModelVec2Stag &diffusivity,
+                                                      const IceModelVec2Stag &diffusive_flux,
+                                                      const IceModelVec2Int &thickness_bc_mask) {
+  PetscErrorCode ierr = 0;
+
+  const double
+    dx  = m_grid->dx(),
+    dy  = m_grid->dy(),
+    C_x = dt / (dx * dx),
+    C_y = dt / (dy * dy);
+
+  const int
+    nrow = 1,
+    ncol = 5,
+    Mx   = m_grid->Mx(),
+    My   = m_grid->My();
+
+  Mat A = m_impl->A;
+  IceModelVec2S &rhs = m_impl->rhs;
+
+  ierr = MatZeroEntries(A); PISM_CHK(ierr, "MatZeroEntries");
+
+  IceModelVec::AccessList list{&cell_type, &ice_thickness, &bed_elevation,
+      &diffusivity, &diffusive_flux, &thickness_bc_mask, &rhs};
+
+  ParallelSection loop(m_grid->com);
+  try {
+    MatStencil row, col[ncol];
+    row.c = 0;
+
+    for (int m = 0; m < ncol; m++) {
+      col[m].c = 0;
+    }
+
+    for (Points p(*m_grid); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      /* i indices */
+      const int I[] = {i, i - 1,  i,  i + 1, i};
+
+      /* j indices */
+      const int J[] = {j + 1, j,  j,  j, j - 1};
+
+      row.i = i;
+      row.j = j;
+
+      for (int m = 0; m < ncol; m++) {
+        col[m].i = I[m];
+        col[m].j = J[m];
+      }
+
+      if (thickness_bc_mask.as_int(i, j) == 1) {
+        // Dirichlet B.C. location: keep ice thickness unchanged
+        double L[ncol] = {0.0,
+                          0.0, 1.0, 0.0,
+                          0.0};
+
+        ierr = MatSetValuesStencil(A, nrow, &row, ncol, col, L, INSERT_VALUES);
+        PISM_CHK(ierr, "MatSetValuesStencil");
+
+        rhs(i, j) = ice_thickness(i, j);
+
+        continue;
+      }
+
+      auto M = cell_type.int_star(i, j);
+      auto D = diffusivity.star(i, j);
+      auto Q = diffusive_flux.star(i, j);
+      auto b = bed_elevation.star(i, j);
+
+      // Flags indicating which interfaces are treated implicitly. Use zero flux at edges
+      // of the computational domain.
+      const bool
+        N = j < My - 1 and implicit_interface(M.ij, M.n),
+        E = i < Mx - 1 and implicit_interface(M.ij, M.e),
+        W = i > 0      and implicit_interface(M.ij, M.w),
+        S = j > 0      and implicit_interface(M.ij, M.s);
+
+      const double
+        c_n = N ? C_y * D.n : 0.0,
+        c_e = E ? C_x * D.e : 0.0,
+        c_w = W ? C_x * D.w : 0.0,
+        c_s = S ? C_y * D.s : 0.0;
+
+      double L[ncol] = {- c_n,
+                        - c_w, 1.0 + c_n + c_e + c_w + c_s, - c_e,
+                        - c_s};
+
+      ierr = MatSetValuesStencil(A, nrow, &row, ncol, col, L, INSERT_VALUES);
+      PISM_CHK(ierr, "MatSetValuesStencil");
+
+      // divergence of the explicit part of the diffusive flux
+      const double
+        Q_n = N ? 0.0 : limit_diffusive_flux(M.ij, M.n, Q.n),
+        Q_e = E ? 0.0 : limit_diffusive_flux(M.ij, M.e, Q.e),
+        Q_w = W ? 0.0 : limit_diffusive_flux(M.w, M.ij, Q.w),
+        Q_s = S ? 0.0 : limit_diffusive_flux(M.s, M.ij, Q.s),
+        divQ = (Q_e - Q_w) / dx + (Q_n - Q_s) / dy;
+
+      rhs(i, j) = (ice_thickness(i, j) +
+                   c_n * (b.n - b.ij) + c_e * (b.e - b.ij) +
+                   c_w * (b.w - b.ij) + c_s * (b.s - b.ij) -
+                   dt * divQ);
+    } // i,j-loop
+  } catch (...) {
+    loop.failed();
+  }
+  loop.check();
+
+  ierr = MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY); PISM_CHK(ierr, "MatAssemblyBegin");
+  ierr = MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY); PISM_CHK(ierr, "MatAssemblyEnd");
+}
+
 /*!
  * Update ice thickness and area_specific_volume *in place*.
  *
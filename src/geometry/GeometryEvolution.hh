@@ -48,6 +48,14 @@ public:
                  const IceModelVec2Int  &velocity_bc_mask,
                  const IceModelVec2Int  &thickness_bc_mask);
 
+  const IceModelVec2Stag& semi_implicit_diffusive_flux(const Geometry &geometry, double dt,
+                                                       const IceModelVec2Stag &diffusivity,
+                                                       const IceModelVec2Stag &diffusive_flux,
+                                                       const IceModelVec2Int  &thickness_bc_mask);
+
+  void estimate_thickness_change_rate(const IceModelVec2Stag &diffusive_flux,
+                                      const IceModelVec2Int  &thickness_bc_mask);
+
   void source_term_step(const Geometry &geometry, double dt,
                         const IceModelVec2Int &thickness_bc_mask,
                         const IceModelVec2S   &surface_mass_flux,
@@ -75,6 +83,16 @@ protected:
 
   virtual void init_impl(const InputOptions &opts);
 
+  MaxTimestep max_timestep_impl(double t) const;
+
+  void assemble_semi_implicit_system(double dt,
+                                     const IceModelVec2CellType &cell_type,
+                                     const IceModelVec2S &ice_thickness,
+                                     const IceModelVec2S &bed_elevation,
+                                     const IceModelVec2Stag &diffusivity,
+                                     const IceModelVec2Stag &diffusive_flux,
+                                     const IceModelVec2Int &thickness_bc_mask);
+
   void update_in_place(double dt,
                        const IceModelVec2S& bed_elevation,
                        const IceModelVec2S& sea_level,
@@ -208,6 +208,15 @@ void IceModel::allocate_storage() {
     m_grid->variables().add(m_basal_yield_stress);
   }
 
+  {
+    m_timestep_limit_count.create(m_grid, "timestep_limit_count", WITHOUT_GHOSTS);
+    m_timestep_limit_count.set_attrs("diagnostic",
+                                     "number of time steps limited by this grid cell"
+                                     " (since the beginning of the run)",
+                                     "1", "1", "", 0);
+    m_timestep_limit_count.set(0.0);
+  }
+
   {
     m_bedtoptemp.create(m_grid, "bedtoptemp", WITHOUT_GHOSTS);
     m_bedtoptemp.set_attrs("diagnostic",
@@ -454,6 +463,11 @@ void IceModel::step(bool do_mass_continuity,
 
   m_stdout_flags += (updateAtDepth ? "v" : "V");
 
+  // the semi-implicit mass transport scheme needs an estimate of the rate of thickness
+  // change to limit the first time step
+  m_geometry_evolution->estimate_thickness_change_rate(m_stress_balance->diffusive_flux(),
+                                                       m_ssa_dirichlet_bc_mask);
+
   //! \li determine the time step according to a variety of stability criteria
   max_timestep(m_dt, m_skip_countdown);
 
@@ -474,6 +488,7 @@ void IceModel::step(bool do_mass_continuity,
   if (m_age_model and updateAtDepth) {
     AgeModelInputs inputs;
     inputs.ice_thickness = &m_geometry.ice_thickness;
+    inputs.cell_type     = &m_geometry.cell_type;
     inputs.u3            = &m_stress_balance->velocity_u();
     inputs.v3            = &m_stress_balance->velocity_v();
     inputs.w3            = &m_stress_balance->velocity_w();
@@ -530,10 +545,20 @@ void IceModel::step(bool do_mass_continuity,
         m_skip_countdown--;
       }
 
+      const IceModelVec2Stag *diffusive_flux = &m_stress_balance->diffusive_flux();
+
+      if (m_config->get_flag("geometry.update.semi_implicit.enabled")) {
+        diffusive_flux = &m_geometry_evolution->semi_implicit_diffusive_flux(m_geometry,
+                                                                             m_dt,
+                                                                             m_stress_balance->diffusivity(),
+                                                                             m_stress_balance->diffusive_flux(),
+                                                                             thickness_bc_mask);
+      }
+
       m_geometry_evolution->flow_step(m_geometry,
                                       m_dt,
                                       m_stress_balance->advective_velocity(),
-                                      m_stress_balance->diffusive_flux(),
+                                      *diffusive_flux,
                                       m_ssa_dirichlet_bc_mask,
                                       thickness_bc_mask);
 
@@ -827,6 +852,8 @@ void IceModel::run() {
 
   profiling.stage_end("time-stepping loop");
 
+  report_timestep_restrictions();
+
   if (stepcount >= 0) {
     m_log->message(1,
                "count_time_steps:  run() took %d steps\n"
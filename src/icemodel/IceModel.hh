@@ -307,6 +307,18 @@ protected:
 
   std::string m_adaptive_timestep_reason;
 
+  //! Time step attribution: the number of time steps limited by each grid cell
+  IceModelVec2S m_timestep_limit_count;
+
+  //! Time step attribution: the number of time steps limited by a given mechanism
+  //! and by each grid location (linear index `j * Mx + i`) for this mechanism
+  struct TimestepLimits {
+    TimestepLimits() : count(0) {}
+    unsigned int count;
+    std::map<int, unsigned int> locations;
+  };
+  std::map<std::string, TimestepLimits> m_timestep_limits;
+
   std::string m_stdout_flags;
 
   // see iceModel.cc
@@ -315,6 +327,8 @@ protected:
   virtual MaxTimestep max_timestep_diffusivity();
   virtual void max_timestep(double &dt_result, unsigned int &skip_counter);
   virtual unsigned int skip_counter(double input_dt, double input_dt_diffusivity);
+  void record_timestep_restriction(const MaxTimestep &restriction);
+  void report_timestep_restrictions() const;
 
   // see energy.cc
   virtual void bedrock_thermal_model_step();
@@ -405,6 +419,8 @@ protected:
 
   //! file to write scalar time-series to
   std::string m_ts_filename;
+  //! the scalar time-series file (kept open during the run)
+  std::shared_ptr<File> m_ts_file;
   //! requested times for scalar time-series
   std::shared_ptr<std::vector<double>> m_ts_times;
   std::set<std::string> m_ts_vars;
@@ -421,6 +437,7 @@ protected:
   std::set<std::string> m_extra_vars;
   TimeBoundsMetadata m_extra_bounds;
   std::unique_ptr<File> m_extra_file;
+  GridWindow m_extra_window;
   void init_extras();
   void write_extras();
   MaxTimestep extras_max_timestep(double my_t);
@@ -2766,6 +2766,7 @@ void IceModel::init_diagnostics() {
 
     // misc
     {"rank", f(new Rank(this))},
+    {"timestep_limit_count", d::wrap(m_timestep_limit_count)},
   };
 
 #if (Pism_USE_PROJ==1)
@@ -43,6 +43,7 @@
 #include "pism/util/Time.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/io/File.hh"
+#include "pism/util/io/RawCheckpoint.hh"
 #include "pism/util/pism_options.hh"
 #include "pism/coupler/OceanModel.hh"
 #include "pism/coupler/SurfaceModel.hh"
@@ -134,6 +135,10 @@ void IceModel::model_state_setup() {
 
   if (use_input_file) {
     input_file.reset(new File(m_grid->com, input.filename, PISM_GUESS, PISM_READONLY));
+
+    if (input.type == INIT_RESTART and m_config->get_flag("input.raw_checkpoint")) {
+      input_file->set_raw_checkpoint(RawCheckpoint::open(*input_file, *m_grid));
+    }
   }
 
   // Initialize 2D fields owned by IceModel (ice geometry, etc)
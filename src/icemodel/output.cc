@@ -30,6 +30,7 @@
 #include "pism/util/Time.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/io/File.hh"
+#include "pism/util/io/RawCheckpoint.hh"
 #include "pism/util/pism_options.hh"
 
 #include "pism/util/Vars.hh"
@@ -136,6 +137,12 @@ void IceModel::save_results() {
               PISM_READWRITE_MOVE,
               m_ctx->pio_iosys_id());
 
+    file.set_storage_settings(StorageSettings(*m_config));
+
+    if (m_config->get_flag("output.raw_checkpoint")) {
+      file.set_raw_checkpoint(RawCheckpoint::create(file, *m_grid));
+    }
+
     write_metadata(file, WRITE_MAPPING, PREPEND_HISTORY);
 
     write_run_stats(file);
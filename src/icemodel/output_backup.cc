@@ -21,6 +21,7 @@
 
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/Profiling.hh"
+#include "pism/util/io/RawCheckpoint.hh"
 
 namespace pism {
 
@@ -68,6 +69,12 @@ void IceModel::write_backup() {
               PISM_READWRITE_MOVE,
               m_ctx->pio_iosys_id());
 
+    file.set_storage_settings(StorageSettings(*m_config));
+
+    if (m_config->get_flag("output.raw_checkpoint")) {
+      file.set_raw_checkpoint(RawCheckpoint::create(file, *m_grid));
+    }
+
     write_metadata(file, WRITE_MAPPING, PREPEND_HISTORY);
     write_run_stats(file);
 
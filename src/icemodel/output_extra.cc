@@ -22,6 +22,9 @@
 #include <netcdf_meta.h>
 #endif
 
+#include <algorithm>            // std::lower_bound, std::upper_bound
+#include <cstdlib>              // strtod
+
 #include "IceModel.hh"
 
 #include "pism/util/pism_options.hh"
@@ -109,6 +112,82 @@ static std::set<std::string> process_extra_shortcuts(const Config &config,
   return result;
 }
 
+//! Parse a range of coordinates ("min,max").
+static void parse_range(const std::string &parameter, const std::string &range,
+                        double &min, double &max) {
+  auto values = split(range, ',');
+
+  bool success = values.size() == 2;
+  if (success) {
+    char *end0 = NULL, *end1 = NULL;
+    min = strtod(values[0].c_str(), &end0);
+    max = strtod(values[1].c_str(), &end1);
+
+    success = (*end0 == '\0' and *end1 == '\0' and min < max);
+  }
+
+  if (not success) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "invalid %s: '%s' (expected 'min,max', with min < max)",
+                                  parameter.c_str(), range.c_str());
+  }
+}
+
+//! Find the range of indexes of grid points `x` in [min, max].
+static void index_range(const std::string &parameter, const std::vector<double> &x,
+                        double min, double max,
+                        unsigned int &start, unsigned int &count) {
+  auto first = std::lower_bound(x.begin(), x.end(), min);
+  auto last  = std::upper_bound(x.begin(), x.end(), max);
+
+  if (first >= last) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "%s = [%f, %f] does not contain any grid points",
+                                  parameter.c_str(), min, max);
+  }
+
+  start = first - x.begin();
+  count = last - first;
+}
+
+//! Get the rectangular part of the grid written to the file containing spatial
+//! time-series.
+/*!
+ * Returns an empty window (i.e. the whole grid) if output.extra.x_range and
+ * output.extra.y_range are not set.
+ */
+static GridWindow extra_window(const IceGrid &grid, const Config &config) {
+  std::string
+    x_range = config.get_string("output.extra.x_range"),
+    y_range = config.get_string("output.extra.y_range");
+
+  if (x_range.empty() and y_range.empty()) {
+    return GridWindow();
+  }
+
+  if (x_range.empty() or y_range.empty()) {
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "please set both output.extra.x_range and output.extra.y_range");
+  }
+
+  double x_min, x_max, y_min, y_max;
+  parse_range("output.extra.x_range", x_range, x_min, x_max);
+  parse_range("output.extra.y_range", y_range, y_min, y_max);
+
+  if (not supports_windows(string_to_backend(config.get_string("output.format")))) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "output.extra.x_range and output.extra.y_range are not"
+                                  " supported with output.format = %s",
+                                  config.get_string("output.format").c_str());
+  }
+
+  GridWindow result;
+  index_range("output.extra.x_range", grid.x(), x_min, x_max, result.x_start, result.x_count);
+  index_range("output.extra.y_range", grid.y(), y_min, y_max, result.y_start, result.y_count);
+
+  return result;
+}
+
 //! Initialize the code saving spatially-variable diagnostic quantities.
 void IceModel::init_extras() {
 
@@ -220,6 +299,17 @@ void IceModel::init_extras() {
   }
 #endif
 
+  m_extra_window = extra_window(*m_grid, *m_config);
+  if (not m_extra_window.empty()) {
+    m_log->message(2, "saving the region x = [%.0f, %.0f] m, y = [%.0f, %.0f] m"
+                   " (%u x %u grid points)\n",
+                   m_grid->x(m_extra_window.x_start),
+                   m_grid->x(m_extra_window.x_start + m_extra_window.x_count - 1),
+                   m_grid->y(m_extra_window.y_start),
+                   m_grid->y(m_extra_window.y_start + m_extra_window.y_count - 1),
+                   m_extra_window.x_count, m_extra_window.y_count);
+  }
+
   if (not vars.empty()) {
     m_extra_vars = process_extra_shortcuts(*m_config, set_split(vars, ','));
     m_log->message(2, "variables requested: %s\n", vars.c_str());
@@ -319,6 +409,19 @@ void IceModel::write_extras() {
                                   string_to_backend(m_config->get_string("output.format")),
                                   mode,
                                   m_ctx->pio_iosys_id()));
+
+      StorageSettings storage(*m_config);
+      storage.chunking = string_to_chunking(m_config->get_string("output.extra.chunking"));
+      storage.significant_bits = m_config->get_number("output.netcdf4.significant_bits");
+      if (storage.significant_bits > 0 and not supports_quantization(m_extra_file->backend())) {
+        m_log->message(2,
+                       "PISM WARNING: output.format '%s' cannot store quantized variables.\n"
+                       "              Ignoring output.netcdf4.significant_bits.\n",
+                       m_config->get_string("output.format").c_str());
+        storage.significant_bits = 0;
+      }
+      m_extra_file->set_storage_settings(storage);
+      m_extra_file->set_window(m_extra_window);
     }
 
     std::string time_name = m_config->get_string("time.dimension_name");
@@ -159,6 +159,9 @@ void IceModel::write_snapshot() {
               mode,
               m_ctx->pio_iosys_id());
 
+    // Snapshots can be used to restart, so they are compressed but never quantized.
+    file.set_storage_settings(StorageSettings(*m_config));
+
     if (not m_snapshots_file_is_ready) {
       write_metadata(file, WRITE_MAPPING, PREPEND_HISTORY);
 
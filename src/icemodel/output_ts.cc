@@ -80,7 +80,9 @@ void IceModel::init_timeseries() {
     // default behavior is to move the file aside if it exists already; option allows appending
     bool append = m_config->get_flag("output.timeseries.append");
     IO_Mode mode = append ? PISM_READWRITE : PISM_READWRITE_MOVE;
-    File file(m_grid->com, m_ts_filename, PISM_NETCDF3, mode);      // Use NetCDF-3 to write time-series.
+    // Use NetCDF-3 to write time-series.
+    m_ts_file.reset(new File(m_grid->com, m_ts_filename, PISM_NETCDF3, mode));
+    const File &file = *m_ts_file;
     // add the last saved time to the list of requested times so that the first time is interpreted
     // as the end of a reporting time step
     if (append and file.dimension_length("time") > 0) {
@@ -99,7 +101,7 @@ void IceModel::init_timeseries() {
 
     // initialize scalar diagnostics
     for (auto d : m_ts_diagnostics) {
-      d.second->init(file, m_ts_times);
+      d.second->init(m_ts_file, m_ts_times);
     }
   }
 }
@@ -123,9 +125,9 @@ void IceModel::flush_timeseries() {
   }
 
   // update run_stats in the time series output file
-  if (not m_ts_diagnostics.empty()) {
-    File file(m_grid->com, m_ts_filename, PISM_NETCDF3, PISM_READWRITE);
-    write_run_stats(file);
+  if (not m_ts_diagnostics.empty() and m_ts_file) {
+    write_run_stats(*m_ts_file);
+    m_ts_file->sync();
   }
 }
 
@@ -52,6 +52,9 @@ Reference: [\ref MortonMayers] pp 62--63.
 MaxTimestep IceModel::max_timestep_diffusivity() {
   double D_max = m_stress_balance->max_diffusivity();
 
+  int i = -1, j = -1;
+  m_stress_balance->max_diffusivity_location(i, j);
+
   if (D_max > 0.0) {
     const double
       dx = m_grid->dx(),
@@ -60,7 +63,7 @@ MaxTimestep IceModel::max_timestep_diffusivity() {
       grid_factor                 = 1.0 / (dx*dx) + 1.0 / (dy*dy);
 
     return MaxTimestep(adaptive_timestepping_ratio * 2.0 / (D_max * grid_factor),
-                       "diffusivity");
+                       "diffusivity", i, j);
   } else {
     return MaxTimestep(m_config->get_number("time_stepping.maximum_time_step", "seconds"),
                        "max time step");
@@ -174,8 +177,14 @@ void IceModel::max_timestep(double &dt_result, unsigned int &skip_counter_result
   if (m_config->get_flag("geometry.update.enabled")) {
     CFLData cfl = m_stress_balance->max_timestep_cfl_2d();
 
-    restrictions.push_back(MaxTimestep(cfl.dt_max.value(), "2D CFL"));
-    restrictions.push_back(max_timestep_diffusivity());
+    restrictions.push_back(MaxTimestep(cfl.dt_max.value(), "2D CFL",
+                                       cfl.dt_max.i(), cfl.dt_max.j()));
+
+    // The semi-implicit scheme is unconditionally stable for the diffusive part of the
+    // flux. In this case the time step is controlled by GeometryEvolution.
+    if (not m_config->get_flag("geometry.update.semi_implicit.enabled")) {
+      restrictions.push_back(max_timestep_diffusivity());
+    }
   }
 
   // Hit multiples of X years, if requested.
@@ -214,6 +223,8 @@ void IceModel::max_timestep(double &dt_result, unsigned int &skip_counter_result
   m_adaptive_timestep_reason = (dt_max.description() +
                                 " (overrides " + dt_other.description() + ")");
 
+  record_timestep_restriction(dt_max);
+
   // the "skipping" mechanism
   {
     if (dt_max.description() == "diffusivity" and skip_counter_result == 0) {
@@ -231,4 +242,81 @@ void IceModel::max_timestep(double &dt_result, unsigned int &skip_counter_result
   }
 }
 
+/*!
+ * Record the time step restriction that was used (time step attribution).
+ *
+ * Increments the number of time steps limited by the mechanism described by
+ * `restriction` and, if the location is known, by the grid cell that limited the step.
+ */
+void IceModel::record_timestep_restriction(const MaxTimestep &restriction) {
+  TimestepLimits &limits = m_timestep_limits[restriction.description()];
+
+  limits.count += 1;
+
+  if (not restriction.has_location()) {
+    return;
+  }
+
+  const int
+    Mx = m_grid->Mx(),
+    i  = restriction.i(),
+    j  = restriction.j();
+
+  limits.locations[j * Mx + i] += 1;
+
+  // only the rank owning (i, j) updates the map
+  if (i >= m_grid->xs() and i < m_grid->xs() + m_grid->xm() and
+      j >= m_grid->ys() and j < m_grid->ys() + m_grid->ym()) {
+    IceModelVec::AccessList list{&m_timestep_limit_count};
+    m_timestep_limit_count(i, j) += 1.0;
+  }
+  m_timestep_limit_count.inc_state_counter();
+
+  m_log->message(3, "  time step limited by %s at i=%d, j=%d (x=%.1f km, y=%.1f km)\n",
+                 restriction.description().c_str(), i, j,
+                 m_grid->x(i) / 1000.0, m_grid->y(j) / 1000.0);
+}
+
+/*!
+ * Print a compact summary of time step restrictions: the number of steps limited by each
+ * mechanism and the grid location that limited it most often.
+ *
+ * See the `timestep_limit_count` diagnostic for the spatial distribution.
+ */
+void IceModel::report_timestep_restrictions() const {
+  if (m_timestep_limits.empty()) {
+    return;
+  }
+
+  const int Mx = m_grid->Mx();
+
+  m_log->message(2, "Time step restrictions:\n");
+
+  for (const auto &m : m_timestep_limits) {
+    const TimestepLimits &limits = m.second;
+
+    if (limits.locations.empty()) {
+      m_log->message(2, "  %-24s %8d steps\n", m.first.c_str(), limits.count);
+      continue;
+    }
+
+    auto worst = limits.locations.begin();
+    for (auto it = limits.locations.begin(); it != limits.locations.end(); ++it) {
+      if (it->second > worst->second) {
+        worst = it;
+      }
+    }
+
+    const int
+      i = worst->first % Mx,
+      j = worst->first / Mx;
+
+    m_log->message(2,
+                   "  %-24s %8d steps (%d locations; most often at i=%d, j=%d"
+                   " (x=%.1f km, y=%.1f km): %d steps)\n",
+                   m.first.c_str(), limits.count, (int)limits.locations.size(),
+                   i, j, m_grid->x(i) / 1000.0, m_grid->y(j) / 1000.0, worst->second);
+  }
+}
+
 } // end of namespace pism
@@ -26,6 +26,7 @@
 #include "pism/util/ConfigInterface.hh"
 #include "pism/util/IceGrid.hh"
 #include "pism/util/Logger.hh"
+#include "pism/util/pism_utilities.hh"
 
 namespace pism {
 namespace inverse {
@@ -195,6 +196,15 @@ public:
     m_dGlobal.copy_from(d);
   }
 
+  //! Sets the number of iterations completed before the current solve (used when
+  //  restarting an inversion from a checkpoint). Listeners see iteration numbers
+  //  counting from this offset.
+  virtual void setIterationOffset(int offset) {
+    m_iteration_offset = offset;
+  }
+
+  virtual void addQuasiNewtonHistory(DesignVec &d, DesignVec &gradient);
+
   //! Callback provided to TAO for objective evaluation.
   virtual void evaluateObjectiveAndGradient(Tao tao, Vec x, double *value, Vec gradient);
 
@@ -232,6 +242,8 @@ public:
 
 protected:
 
+  void restoreQuasiNewtonHistory(Tao tao);
+
   IceGrid::ConstPtr m_grid;
   
   ForwardProblem &m_forward;
@@ -289,6 +301,12 @@ protected:
   */
   double m_tikhonov_rtol;
 
+  /// Number of iterations completed before the current solve.
+  int m_iteration_offset;
+
+  /// Iterates and gradients used to re-build the quasi-Newton (L-BFGS) approximation of the
+  /// Hessian when restarting.
+  std::vector<DesignVecPtr> m_history_d, m_history_gradient;
 };
 
 template<class ForwardProblem>
@@ -298,7 +316,8 @@ IPTaoTikhonovProblem<ForwardProblem>::IPTaoTikhonovProblem(ForwardProblem &forwa
                                                            IPFunctional<DesignVec> &designFunctional,
                                                            IPFunctional<StateVec> &stateFunctional)
   : m_forward(forward), m_d0(d0), m_u_obs(u_obs), m_eta(eta),
-    m_designFunctional(designFunctional), m_stateFunctional(stateFunctional) {
+    m_designFunctional(designFunctional), m_stateFunctional(stateFunctional),
+    m_iteration_offset(0) {
 
   m_grid = m_d0.grid();
 
@@ -363,15 +382,90 @@ void IPTaoTikhonovProblem<ForwardProblem>::connect(Tao tao) {
 #endif
 }
 
+//! Adds an iterate and the corresponding gradient of the Tikhonov functional to the
+//! quasi-Newton history.
+/*! Use this (in the order of increasing iteration numbers) to restart an inversion from
+  a checkpoint: the stored pairs are used to re-build the limited-memory BFGS
+  approximation of the Hessian at the beginning of the next solve, so a restarted
+  inversion continues with the same search directions instead of starting with a
+  steepest descent step. The history is ignored by TAO methods other than `lmvm`.
+*/
+template<class ForwardProblem>
+void IPTaoTikhonovProblem<ForwardProblem>::addQuasiNewtonHistory(DesignVec &d,
+                                                                 DesignVec &gradient) {
+  int N = m_history_d.size();
+
+  DesignVecPtr d_copy(new DesignVec);
+  d_copy->create(m_grid, pism::printf("design history %d", N), WITHOUT_GHOSTS);
+  d_copy->copy_from(d);
+  m_history_d.push_back(d_copy);
+
+  DesignVecPtr gradient_copy(new DesignVec);
+  gradient_copy->create(m_grid, pism::printf("gradient history %d", N), WITHOUT_GHOSTS);
+  gradient_copy->copy_from(gradient);
+  m_history_gradient.push_back(gradient_copy);
+}
+
+//! Feeds the stored quasi-Newton history to the L-BFGS matrix used by TAO.
+template<class ForwardProblem>
+void IPTaoTikhonovProblem<ForwardProblem>::restoreQuasiNewtonHistory(Tao tao) {
+  Logger::ConstPtr log = m_grid->ctx()->log();
+
+#if PETSC_VERSION_LT(3,11,0)
+  (void) tao;
+  log->message(2,
+               "IPTaoTikhonovProblem: restoring the quasi-Newton history requires PETSc 3.11 or newer;"
+               " ignoring it\n");
+#else
+  PetscErrorCode ierr;
+
+  PetscBool is_lmvm = PETSC_FALSE;
+  ierr = PetscObjectTypeCompare((PetscObject)tao, TAOLMVM, &is_lmvm);
+  PISM_CHK(ierr, "PetscObjectTypeCompare");
+
+  if (is_lmvm) {
+    Mat B;
+    ierr = TaoGetLMVMMatrix(tao, &B);
+    PISM_CHK(ierr, "TaoGetLMVMMatrix");
+
+    for (unsigned int k = 0; k < m_history_d.size(); ++k) {
+      ierr = MatLMVMUpdate(B, m_history_d[k]->vec(), m_history_gradient[k]->vec());
+      PISM_CHK(ierr, "MatLMVMUpdate");
+    }
+
+    // TaoSolve_LMVM() resets the L-BFGS matrix *after* calling the monitor for iteration
+    // 0 unless "recycling" is enabled. Enable it to keep the history added above.
+    ierr = TaoLMVMRecycle(tao, PETSC_TRUE);
+    PISM_CHK(ierr, "TaoLMVMRecycle");
+
+    log->message(2, "IPTaoTikhonovProblem: restored %d quasi-Newton updates\n",
+                 (int)m_history_d.size());
+  } else {
+    log->message(2,
+                 "IPTaoTikhonovProblem: the quasi-Newton history is used by 'lmvm' only;"
+                 " ignoring it\n");
+  }
+#endif
+
+  m_history_d.clear();
+  m_history_gradient.clear();
+}
+
 template<class ForwardProblem>
 void IPTaoTikhonovProblem<ForwardProblem>::monitorTao(Tao tao) {
   PetscInt its;
   TaoGetSolutionStatus(tao, &its, NULL, NULL, NULL, NULL, NULL);
 
+  // The L-BFGS matrix is set up (and empty) when TAO calls the monitor for the first
+  // time. See restoreQuasiNewtonHistory() for the reset that follows this call.
+  if (its == 0 and not m_history_d.empty()) {
+    restoreQuasiNewtonHistory(tao);
+  }
+
   int nListeners = m_listeners.size();
   for (int k=0; k<nListeners; k++) {
     m_listeners[k]->iteration(*this, m_eta,
-                              its, m_val_design, m_val_state,
+                              its + m_iteration_offset, m_val_design, m_val_state,
                               m_d, m_d_diff, m_grad_design,
                               m_forward.solution(), m_u_diff, m_grad_state,
                               m_grad);
@@ -390,6 +484,9 @@ template<class ForwardProblem> void IPTaoTikhonovProblem<ForwardProblem>::conver
 
   designNorm *= dWeight;    
   stateNorm  *= sWeight;
+
+  // Tighten the tolerance of forward solves as the inversion converges.
+  m_forward.set_forward_progress(sumNorm / std::max(designNorm, stateNorm));
   
   if (sumNorm < m_tikhonov_atol) {
     TaoSetConvergedReason(tao, TAO_CONVERGED_GATOL);
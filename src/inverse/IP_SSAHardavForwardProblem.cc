@@ -16,6 +16,8 @@
 // along with PISM; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
+#include <algorithm>              // std::min, std::max
+
 #include "IP_SSAHardavForwardProblem.hh"
 #include "pism/basalstrength/basal_resistance.hh"
 #include "pism/util/IceGrid.hh"
@@ -40,7 +42,10 @@ IP_SSAHardavForwardProblem::IP_SSAHardavForwardProblem(IceGrid::ConstPtr g,
     m_element_index(*m_grid),
     m_element(*m_grid),
     m_quadrature(g->dx(), g->dy(), 1.0),
-    m_rebuild_J_state(true) {
+    m_rebuild_J_state(true),
+    m_forward_inexact(m_config->get_flag("inverse.ssa.forward_inexact")),
+    m_forward_rtol_max(m_config->get_number("inverse.ssa.forward_rtol_max")),
+    m_forward_rtol_min(0.0) {
 
   PetscErrorCode ierr;
   int stencilWidth = 1;
@@ -79,6 +84,27 @@ IP_SSAHardavForwardProblem::IP_SSAHardavForwardProblem(IceGrid::ConstPtr g,
 
   ierr = KSPSetFromOptions(m_ksp);
   PISM_CHK(ierr, "KSPSetFromOptions");
+
+  // The tolerance set using command-line options is the tightest one used by the inexact
+  // Newton schedule (see set_forward_progress()).
+  ierr = SNESGetTolerances(m_snes, NULL, &m_forward_rtol_min, NULL, NULL, NULL);
+  PISM_CHK(ierr, "SNESGetTolerances");
+
+  // If the user set the tolerance explicitly it is also the loosest one: the schedule
+  // never relaxes a tolerance requested on the command line.
+  {
+    const char *prefix = NULL;
+    ierr = SNESGetOptionsPrefix(m_snes, &prefix);
+    PISM_CHK(ierr, "SNESGetOptionsPrefix");
+
+    PetscBool rtol_set = PETSC_FALSE;
+    ierr = PetscOptionsHasName(NULL, prefix, "-snes_rtol", &rtol_set);
+    PISM_CHK(ierr, "PetscOptionsHasName");
+
+    if (rtol_set) {
+      m_forward_rtol_max = std::min(m_forward_rtol_max, m_forward_rtol_min);
+    }
+  }
 }
 
 void IP_SSAHardavForwardProblem::init() {
@@ -149,9 +175,63 @@ void IP_SSAHardavForwardProblem::set_design(IceModelVec2S &new_zeta) {
 in conjuction with apply_linearization and apply_linearization_transpose.*/
 TerminationReason::Ptr IP_SSAHardavForwardProblem::linearize_at(IceModelVec2S &zeta) {
   this->set_design(zeta);
+
+  // Warm-start from the last converged solution. (m_velocity_global may contain the
+  // iterate of a failed solve, e.g. at a rejected line search step.)
+  m_velocity_global.copy_from(m_velocity);
+
   return this->solve_nocache();
 }
 
+//! Sets the relative tolerance of the next forward solve using the progress of the outer iteration.
+/*! If `inverse.ssa.forward_inexact` is set, the SNES relative tolerance is set to
+  \f$\min(r_{\max}, \max(r_{\min}, r_{\max}\,p))\f$, where \f$p\f$ is the relative norm of the
+  gradient of the objective functional reported by the outer (TAO or Gauss-Newton) solver,
+  \f$r_{\max}\f$ is `inverse.ssa.forward_rtol_max`, and \f$r_{\min}\f$ is the SNES relative
+  tolerance set using command-line options. Early outer iterations use cheap, inexact forward
+  solves; the tolerance tightens as the inversion converges.
+
+  If `-snes_rtol` is set explicitly \f$r_{\max}\f$ is capped at its value, so the tolerance
+  requested by the user is never relaxed. The tolerance of linear solves (`-ksp_rtol`) is not
+  modified.
+
+  Does nothing if `inverse.ssa.forward_inexact` is not set.
+*/
+void IP_SSAHardavForwardProblem::set_forward_progress(double progress) {
+  if (not m_forward_inexact) {
+    return;
+  }
+
+  PetscErrorCode ierr;
+  double atol, rtol, stol;
+  PetscInt max_it, max_f;
+  ierr = SNESGetTolerances(m_snes, &atol, &rtol, &stol, &max_it, &max_f);
+  PISM_CHK(ierr, "SNESGetTolerances");
+
+  rtol = std::min(m_forward_rtol_max, std::max(m_forward_rtol_min, m_forward_rtol_max * progress));
+
+  ierr = SNESSetTolerances(m_snes, atol, rtol, stol, max_it, max_f);
+  PISM_CHK(ierr, "SNESSetTolerances");
+
+  m_log->message(4, "IP_SSAHardavForwardProblem: forward solve relative tolerance set to %g\n", rtol);
+}
+
+//! Assembles the state Jacobian and updates the preconditioner if the design or the state changed.
+/*! The matrix and its preconditioner are shared by apply_linearization and
+  apply_linearization_transpose and are re-used until the next call to set_design. */
+void IP_SSAHardavForwardProblem::update_linearization() {
+  if (not m_rebuild_J_state) {
+    return;
+  }
+
+  this->assemble_jacobian_state(m_velocity, m_J_state);
+
+  PetscErrorCode ierr = KSPSetOperators(m_ksp, m_J_state, m_J_state);
+  PISM_CHK(ierr, "KSPSetOperators");
+
+  m_rebuild_J_state = false;
+}
+
 //! Computes the residual function \f$\mathcal{R}(u, \zeta)\f$ as defined in the class-level documentation.
 /* The value of \f$\zeta\f$ is set prior to this call via set_design or linearize_at. The value
 of the residual is returned in \a RHS.*/
@@ -581,18 +661,12 @@ void IP_SSAHardavForwardProblem::apply_linearization(IceModelVec2S &dzeta, IceMo
 
   PetscErrorCode ierr;
 
-  if (m_rebuild_J_state) {
-    this->assemble_jacobian_state(m_velocity, m_J_state);
-    m_rebuild_J_state = false;
-  }
+  this->update_linearization();
 
   this->apply_jacobian_design(m_velocity, dzeta, m_du_global);
   m_du_global.scale(-1);
 
   // call PETSc to solve linear system by iterative method.
-  ierr = KSPSetOperators(m_ksp, m_J_state, m_J_state);
-  PISM_CHK(ierr, "KSPSetOperators");
-
   ierr = KSPSolve(m_ksp, m_du_global.vec(), m_du_global.vec());
   PISM_CHK(ierr, "KSPSolve"); // SOLVE
 
@@ -636,10 +710,7 @@ void IP_SSAHardavForwardProblem::apply_linearization_transpose(IceModelVec2V &du
 
   PetscErrorCode ierr;
 
-  if (m_rebuild_J_state) {
-    this->assemble_jacobian_state(m_velocity, m_J_state);
-    m_rebuild_J_state = false;
-  }
+  this->update_linearization();
 
   // Aliases to help with notation consistency below.
   const IceModelVec2Int *dirichletLocations = m_bc_mask;
@@ -656,9 +727,6 @@ void IP_SSAHardavForwardProblem::apply_linearization_transpose(IceModelVec2V &du
   m_du_global.end_access();
 
   // call PETSc to solve linear system by iterative method.
-  ierr = KSPSetOperators(m_ksp, m_J_state, m_J_state);
-  PISM_CHK(ierr, "KSPSetOperators");
-
   ierr = KSPSolve(m_ksp, m_du_global.vec(), m_du_global.vec());
   PISM_CHK(ierr, "KSPSolve"); // SOLVE
 
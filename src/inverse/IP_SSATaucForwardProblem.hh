@@ -146,6 +146,8 @@ public:
 
   virtual TerminationReason::Ptr linearize_at(IceModelVec2S &zeta);
 
+  virtual void set_forward_progress(double progress);
+
   virtual void assemble_residual(IceModelVec2V &u, IceModelVec2V &R);
   virtual void assemble_residual(IceModelVec2V &u, Vec R);
 
@@ -169,6 +171,8 @@ public:
 
 protected:
 
+  void update_linearization();
+
   /// Current value of zeta, provided from caller.
   IceModelVec2S   *m_zeta;
   /// Storage for d_zeta with ghosts, if needed when an argument d_zeta is ghost-less.
@@ -203,6 +207,13 @@ protected:
 
   /// Flag indicating that the state jacobian matrix needs rebuilding.
   bool m_rebuild_J_state;
+
+  /// Flag indicating that forward solves use the inexact Newton tolerance schedule.
+  bool m_forward_inexact;
+  /// Loosest SNES relative tolerance used by the inexact Newton schedule.
+  double m_forward_rtol_max;
+  /// Tightest SNES relative tolerance used by the inexact Newton schedule.
+  double m_forward_rtol_min;
 };
 
 } // end of namespace inverse
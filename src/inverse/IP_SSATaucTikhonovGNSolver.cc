@@ -230,6 +230,9 @@ TerminationReason::Ptr IP_SSATaucTikhonovGNSolver::check_convergence() {
              "design norm %g stateNorm %g sum %g; relative difference %g\n",
              designNorm, stateNorm, sumNorm, relsum);
 
+  // Tighten the tolerance of forward solves as the inversion converges.
+  m_ssaforward.set_forward_progress(relsum);
+
   // If we have an adaptive tikhonov parameter, check if we have met
   // this constraint first.
   if (m_tikhonov_adaptive) {
@@ -0,0 +1,232 @@
+// Copyright (C) 2020 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 3 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+static char help[] =
+  "Ensemble driver for PISM: runs several independent pismr-style simulations\n"
+  "(ensemble members) in one MPI job.\n";
+
+#include <memory>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <mpi.h>
+#include <petscsys.h>           // PETSC_COMM_WORLD
+
+#include "pism/util/IceGrid.hh"
+#include "pism/icemodel/IceModel.hh"
+#include "pism/util/Config.hh"
+
+#include "pism/util/pism_options.hh"
+#include "pism/util/petscwrappers/PetscInitializer.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/Profiling.hh"
+#include "pism/util/pism_utilities.hh"
+
+#include "pism/regional/IceGrid_Regional.hh"
+#include "pism/regional/IceRegionalModel.hh"
+
+using namespace pism;
+
+//! Get the value of a command-line option before PETSc is initialized.
+/*!
+ * Returns NULL if the option is not set.
+ */
+static const char* early_option(int argc, char *argv[], const char *name) {
+  for (int k = 1; k < argc - 1; ++k) {
+    if (strcmp(argv[k], name) == 0) {
+      return argv[k + 1];
+    }
+  }
+  return NULL;
+}
+
+//! Replace all occurrences of `%d` in `input` with `member`.
+static std::string member_string(const std::string &input, int member) {
+  std::string result = input;
+  std::string index = pism::printf("%d", member);
+
+  size_t pos = result.find("%d");
+  while (pos != std::string::npos) {
+    result.replace(pos, 2, index);
+    pos = result.find("%d", pos + index.size());
+  }
+  return result;
+}
+
+//! Set up the configuration of an ensemble member.
+/*!
+ * Each member reads configuration overrides from the file named using the
+ * `-ensemble_config_override` option (`%d` is replaced with the member index). This has
+ * to be done before the context (and the configuration database) is created.
+ */
+static void set_member_overrides(int member) {
+  options::String overrides("-ensemble_config_override",
+                            "Per-member configuration override file ('%d' is replaced by the member index)");
+  if (overrides.is_set()) {
+    std::string filename = member_string(overrides, member);
+
+    PetscErrorCode ierr = PetscOptionsSetValue(NULL, "-config_override", filename.c_str());
+    PISM_CHK(ierr, "PetscOptionsSetValue");
+  }
+}
+
+//! Replace `%d` with the member index in all string parameters (file names).
+static void set_member_file_names(Config &config, int member) {
+  for (auto s : config.all_strings()) {
+    if (s.second.find("%d") != std::string::npos) {
+      config.set_string(s.first, member_string(s.second, member));
+    }
+  }
+}
+
+static int run_member(MPI_Comm com, int member, int ensemble_size) {
+  try {
+    set_member_overrides(member);
+
+    Context::Ptr ctx = context_from_options(com, "pism_ensemble");
+    Logger::Ptr log = ctx->log();
+
+    std::string usage =
+      "  mpiexec -n N pism_ensemble -ensemble_size M -i IN.nc [-bootstrap] [-regional]\n"
+      "              [-ensemble_config_override overrides_%d.nc] [-o output_%d.nc]\n"
+      "              [OTHER PISM & PETSc OPTIONS]\n"
+      "where:\n"
+      "  -ensemble_size            number of ensemble members (M has to divide N)\n"
+      "  -ensemble_config_override per-member configuration override file\n"
+      "  -i                        IN.nc is input file in NetCDF format: contains PISM-written model state\n"
+      "  -bootstrap                enable heuristics to produce an initial state from an incomplete input\n"
+      "  -regional                 enable \"regional mode\"\n"
+      "notes:\n"
+      "  * option -i is required\n"
+      "  * '%d' in -ensemble_config_override and in all file names is replaced\n"
+      "    by the index of an ensemble member\n";
+    {
+      std::vector<std::string> required(1, "-i");
+
+      bool done = show_usage_check_req_opts(*log, "PISM_ENSEMBLE (ensemble of evolution runs)",
+                                            required, usage);
+      if (done) {
+        return 0;
+      }
+    }
+
+    // Processed in main(); this makes it known to PETSc's options database (-help).
+    options::Integer("-ensemble_size", "Number of ensemble members", ensemble_size);
+
+    Config::Ptr config = ctx->config();
+
+    set_member_file_names(*config, member);
+
+    log->message(2, "* Ensemble member %d of %d (%d processes)\n",
+                 member, ensemble_size, (int)ctx->size());
+
+    options::String profiling_log = options::String("-profile",
+                                                    "Save detailed profiling data to a file.");
+    if (profiling_log.is_set()) {
+      ctx->profiling().start();
+    }
+
+    IceGrid::Ptr grid;
+    std::unique_ptr<IceModel> model;
+
+    if (options::Bool("-regional", "enable regional (outlet glacier) mode")) {
+      grid = regional_grid_from_options(ctx);
+      model.reset(new IceRegionalModel(grid, ctx));
+    } else {
+      grid = IceGrid::FromOptions(ctx);
+      model.reset(new IceModel(grid, ctx));
+    }
+
+    model->init();
+
+    model->run();
+
+    log->message(2, "... done with run\n");
+
+    model->save_results();
+
+    print_unused_parameters(*log, 3, *config);
+
+    if (profiling_log.is_set()) {
+      ctx->profiling().report(member_string(profiling_log, member));
+    }
+  }
+  catch (...) {
+    handle_fatal_errors(com);
+    return 1;
+  }
+
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+
+  MPI_Init(&argc, &argv);
+
+  int rank = 0, size = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  // The number of members has to be known before PETSc is initialized: PETSC_COMM_WORLD is
+  // set to the communicator of a member.
+  int ensemble_size = 1;
+  {
+    const char *value = early_option(argc, argv, "-ensemble_size");
+    if (value != NULL) {
+      ensemble_size = atoi(value);
+    }
+
+    if (ensemble_size < 1 or size % ensemble_size != 0) {
+      if (rank == 0) {
+        fprintf(stderr,
+                "PISM ERROR: -ensemble_size (%d) has to be a positive divisor"
+                " of the number of MPI processes (%d)\n",
+                ensemble_size, size);
+      }
+      MPI_Finalize();
+      return 1;
+    }
+  }
+
+  // Consecutive ranks (i.e. processes on the same node, usually) belong to the same
+  // member.
+  int member = rank / (size / ensemble_size);
+
+  MPI_Comm member_comm;
+  MPI_Comm_split(MPI_COMM_WORLD, member, rank, &member_comm);
+
+  PETSC_COMM_WORLD = member_comm;
+
+  int status = 0;
+  {
+    // PETSc uses MPI initialized above and will not finalize it.
+    petsc::Initializer petsc(argc, argv, help);
+
+    status = run_member(member_comm, member, ensemble_size);
+  }
+
+  // Report failure if any of the members failed.
+  int global_status = 0;
+  MPI_Allreduce(&status, &global_status, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+
+  MPI_Comm_free(&member_comm);
+  MPI_Finalize();
+
+  return global_status;
+}
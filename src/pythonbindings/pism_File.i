@@ -1,14 +1,20 @@
 %{
 #include "util/io/File.hh"
 #include "util/io/io_helpers.hh"
+#include "util/io/RawCheckpoint.hh"
 %}
 
+%shared_ptr(pism::RawCheckpoint)
+%ignore pism::RawCheckpoint::read;
+%ignore pism::RawCheckpoint::write;
+
 %ignore pism::File::read_variable(const std::string &, const std::vector<unsigned int> &, const std::vector<unsigned int> &, double *) const;
 %ignore pism::File::write_variable(const std::string &, const std::vector<unsigned int> &, const std::vector<unsigned int> &, const double *) const;
 
 %include "util/io/IO_Flags.hh"
 %include "util/io/File.hh"
 %include "util/io/io_helpers.hh"
+%include "util/io/RawCheckpoint.hh"
 
 %extend pism::File
 {
@@ -3,6 +3,8 @@
 #include "util/IceModelVec2CellType.hh"
 #include "util/iceModelVec2T.hh"
 #include "util/iceModelVec3Custom.hh"
+#include "util/CompactMask.hh"
+#include "util/RaggedColumns.hh"
 
 using namespace pism;
 %}
@@ -19,6 +21,8 @@ using namespace pism;
 %shared_ptr(pism::IceModelVec3D)
 %shared_ptr(pism::IceModelVec3)
 %shared_ptr(pism::IceModelVec3Custom)
+%shared_ptr(pism::CompactMask)
+%shared_ptr(pism::RaggedColumns)
 
 %ignore pism::AccessList::AccessList(std::initializer_list<const PetscAccessible *>);
 
@@ -123,6 +127,78 @@ using namespace pism;
     }
 };
 
+%ignore pism::IceModelVec2Stag::operator();
+%extend pism::IceModelVec2Stag
+{
+  double getitem(int i, int j, int k)
+  {
+      return (*($self))(i,j,k);
+  }
+
+  void setitem(int i, int j, int k, double val)
+  {
+      (*($self))(i,j,k) = val;
+  }
+
+    %pythoncode {
+    def __getitem__(self,*args):
+        return self.getitem(args[0][0],args[0][1],args[0][2])
+
+    def __setitem__(self,*args):
+        if(len(args)==2):
+            self.setitem(args[0][0],args[0][1],args[0][2],args[1])
+        else:
+            raise ValueError("__setitem__ requires 2 arguments; received %d" % len(args));
+    }
+};
+
+%ignore pism::CompactMask::operator();
+%ignore pism::CompactMask::set(int, int, int);
+%ignore pism::CompactMask::star;
+%ignore pism::CompactMask::box;
+%extend pism::CompactMask
+{
+  int getitem(int i, int j)
+  {
+      return (*($self))(i,j);
+  }
+
+  void setitem(int i, int j, int val)
+  {
+      $self->set(i, j, val);
+  }
+
+    %pythoncode {
+    def __getitem__(self,*args):
+        return self.getitem(args[0][0],args[0][1])
+
+    def __setitem__(self,*args):
+        if(len(args)==2):
+            self.setitem(args[0][0],args[0][1],args[1])
+        else:
+            raise ValueError("__setitem__ requires 2 arguments; received %d" % len(args));
+    }
+};
+
+%ignore pism::RaggedColumns::get_column;
+%ignore pism::RaggedColumns::set_column(int, int, const double*);
+%extend pism::RaggedColumns
+{
+std::vector<double> get_column(int i, int j) {
+  const double *column = $self->get_column(i, j);
+  return std::vector<double>(column, column + $self->n_levels(i, j));
+}
+
+void set_column(int i, int j, const std::vector<double> &values) {
+  if (values.size() < $self->n_levels(i, j)) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "expected %d values, got %d",
+                                  (int)$self->n_levels(i, j), (int)values.size());
+  }
+  $self->set_column(i, j, values.data());
+}
+};
+
 %ignore pism::IceModelVec2T::interp(int, int, double*);
 %extend pism::IceModelVec2T
 {
@@ -143,3 +219,6 @@ std::vector<double> interp(int i, int j) {
 %include "util/Vector2.hh"
 
 %include "util/iceModelVec3Custom.hh"
+
+%include "util/CompactMask.hh"
+%include "util/RaggedColumns.hh"
@@ -72,7 +72,7 @@ static int weight(int M_ij, int M_n, double h_ij, double h_n) {
 
 void SSAFD_Regional::compute_driving_stress(const IceModelVec2S &ice_thickness,
                                             const IceModelVec2S &surface_elevation,
-                                            const IceModelVec2CellType &cell_type,
+                                            const CompactMask &cell_type,
                                             const IceModelVec2Int *no_model_mask,
                                             IceModelVec2V &result) const {
 
@@ -106,7 +106,7 @@ void SSAFD_Regional::compute_driving_stress(const IceModelVec2S &ice_thickness,
     }
 
     auto h = m_h_stored->star(i, j);
-    auto CT = cell_type.int_star(i, j);
+    auto CT = cell_type.star(i, j);
 
     // x-derivative
     double h_x = 0.0;
@@ -35,9 +35,9 @@ public:
   virtual void init();
   virtual void compute_driving_stress(const IceModelVec2S &ice_thickness,
                                       const IceModelVec2S &surface_elevation,
-                                      const IceModelVec2CellType &cell_type,
+                                      const CompactMask &cell_type,
                                       const IceModelVec2Int *no_model_mask,
-                                      IceModelVec2V &result) const;
+                                      IceModelVec2V &result) const override;
 
 private:
   void update(const Inputs &inputs, bool full_update);
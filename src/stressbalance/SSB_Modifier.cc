@@ -31,10 +31,13 @@ SSB_Modifier::SSB_Modifier(IceGrid::ConstPtr g)
   : Component(g),
     m_EC(g->ctx()->enthalpy_converter()),
     m_diffusive_flux(m_grid, "diffusive_flux", WITH_GHOSTS, 1),
+    m_diffusivity(m_grid, "diffusivity", WITH_GHOSTS, 1),
     m_u(m_grid, "uvel", WITH_GHOSTS),
     m_v(m_grid, "vvel", WITH_GHOSTS),
     m_strain_heating(m_grid, "strainheat", WITHOUT_GHOSTS) {
-  m_D_max = 0.0;
+  m_D_max   = 0.0;
+  m_D_max_i = -1;
+  m_D_max_j = -1;
 
   m_u.set_attrs("diagnostic", "horizontal velocity of ice in the X direction",
                 "m s-1", "m year-1", "land_ice_x_velocity", 0);
@@ -52,6 +55,11 @@ SSB_Modifier::SSB_Modifier(IceGrid::ConstPtr g)
                              "diffusive (SIA) flux components on the staggered grid",
                              "", "", "", 0);
 
+  m_diffusivity.set_attrs("internal",
+                          "diffusivity of SIA flow on the staggered grid",
+                          "m2 s-1", "m2 s-1", "", 0);
+  // The default modifier does not use diffusion.
+  m_diffusivity.set(0.0);
 }
 
 SSB_Modifier::~SSB_Modifier() {
@@ -70,6 +78,26 @@ double SSB_Modifier::max_diffusivity() const {
   return m_D_max;
 }
 
+/*!
+ * Get the grid location (i, j) of the maximum diffusivity.
+ *
+ * Indexes are negative if the location is not known (e.g. if the diffusivity is zero).
+ */
+void SSB_Modifier::max_diffusivity_location(int &i, int &j) const {
+  i = m_D_max_i;
+  j = m_D_max_j;
+}
+
+/*!
+ * Get the diffusivity of the SIA flow on the staggered grid.
+ *
+ * Used by the semi-implicit mass transport scheme. The default implementation returns
+ * zeros.
+ */
+const IceModelVec2Stag& SSB_Modifier::diffusivity() const {
+  return m_diffusivity;
+}
+
 const IceModelVec3& SSB_Modifier::velocity_u() const {
   return m_u;
 }
@@ -141,7 +169,9 @@ void ConstantInColumn::update(const IceModelVec2V &sliding_velocity,
 
   // diffusive flux and maximum diffusivity
   m_diffusive_flux.set(0.0);
-  m_D_max = 0.0;
+  m_D_max   = 0.0;
+  m_D_max_i = -1;
+  m_D_max_j = -1;
 }
 
 } // end of namespace stressbalance
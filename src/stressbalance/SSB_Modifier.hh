@@ -53,6 +53,12 @@ public:
   //! \brief Get the max diffusivity (for the adaptive time-stepping).
   virtual double max_diffusivity() const;
 
+  //! \brief Get the grid location of the max diffusivity (negative if not known).
+  void max_diffusivity_location(int &i, int &j) const;
+
+  //! \brief Get the diffusivity of the SIA flow on the staggered grid.
+  virtual const IceModelVec2Stag& diffusivity() const;
+
   const IceModelVec3& velocity_u() const;
 
   const IceModelVec3& velocity_v() const;
@@ -67,7 +73,10 @@ protected:
   std::shared_ptr<rheology::FlowLaw> m_flow_law;
   EnthalpyConverter::Ptr m_EC;
   double m_D_max;
+  //! location of the maximum diffusivity
+  int m_D_max_i, m_D_max_j;
   IceModelVec2Stag m_diffusive_flux;
+  IceModelVec2Stag m_diffusivity;
   IceModelVec3 m_u, m_v, m_strain_heating;
 };
 
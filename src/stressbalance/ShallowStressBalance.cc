@@ -25,6 +25,7 @@
 #include "pism/util/error_handling.hh"
 #include "pism/util/pism_options.hh"
 #include "pism/util/IceModelVec2CellType.hh"
+#include "pism/util/CompactMask.hh"
 
 #include "SSB_diagnostics.hh"
 
@@ -161,20 +162,20 @@ void ZeroSliding::update(const Inputs &inputs, bool full_update) {
 
   \param[in] V *basal* sliding velocity
   \param[in] tauc basal yield stress
-  \param[in] mask (used to determine if floating or grounded)
+  \param[in] cell_type cell type mask (used to determine if floating or grounded)
   \param[out] result
  */
 void ShallowStressBalance::compute_basal_frictional_heating(const IceModelVec2V &V,
                                                             const IceModelVec2S &tauc,
-                                                            const IceModelVec2CellType &mask,
+                                                            const CompactMask &cell_type,
                                                             IceModelVec2S &result) const {
 
-  IceModelVec::AccessList list{&V, &result, &tauc, &mask};
+  IceModelVec::AccessList list{&V, &result, &tauc, &cell_type};
 
   for (Points p(*m_grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
-    if (mask.ocean(i,j)) {
+    if (mask::ocean(cell_type(i,j))) {
       result(i,j) = 0.0;
     } else {
       const double
@@ -31,6 +31,7 @@ class FlowLaw;
 class IceGrid;
 class IceBasalResistancePlasticLaw;
 class IceModelVec2CellType;
+class CompactMask;
 
 namespace stressbalance {
 
@@ -63,7 +64,7 @@ public:
 
   void compute_basal_frictional_heating(const IceModelVec2V &velocity,
                                         const IceModelVec2S &tauc,
-                                        const IceModelVec2CellType &mask,
+                                        const CompactMask &cell_type,
                                         IceModelVec2S &result) const;
   // helpers:
 
@@ -230,6 +230,14 @@ double StressBalance::max_diffusivity() const {
   return m_modifier->max_diffusivity();
 }
 
+void StressBalance::max_diffusivity_location(int &i, int &j) const {
+  m_modifier->max_diffusivity_location(i, j);
+}
+
+const IceModelVec2Stag& StressBalance::diffusivity() const {
+  return m_modifier->diffusivity();
+}
+
 const IceModelVec3& StressBalance::velocity_u() const {
   return m_modifier->velocity_u();
 }
@@ -97,6 +97,12 @@ public:
   //! \brief Get the max diffusivity (for the adaptive time-stepping).
   double max_diffusivity() const;
 
+  //! \brief Get the grid location of the max diffusivity.
+  void max_diffusivity_location(int &i, int &j) const;
+
+  //! \brief Get the diffusivity of the SIA flow on the staggered grid.
+  const IceModelVec2Stag& diffusivity() const;
+
   CFLData max_timestep_cfl_2d() const;
   CFLData max_timestep_cfl_3d() const;
 
@@ -613,6 +613,9 @@ void SIAFD::compute_diffusivity(bool full_update,
   std::vector<double> e_factor(Mz, enhancement_factor);
 
   double D_max = 0.0;
+  // maximum over locally owned points and the linear index of its location
+  double D_max_owned = 0.0;
+  int D_max_index = -1;
   int high_diffusivity_counter = 0;
   for (int o=0; o<2; o++) {
     ParallelSection loop(m_grid->com);
@@ -728,6 +731,14 @@ void SIAFD::compute_diffusivity(bool full_update,
 
         D_max = std::max(D_max, D);
 
+        // ghost points are owned by a neighboring rank which will report them
+        if (D > D_max_owned and
+            i >= m_grid->xs() and i < m_grid->xs() + m_grid->xm() and
+            j >= m_grid->ys() and j < m_grid->ys() + m_grid->ym()) {
+          D_max_owned = D;
+          D_max_index = j * static_cast<int>(Mx) + i;
+        }
+
         result(i, j, o) = D;
 
         // if doing the full update, fill the delta column above the ice and
@@ -747,6 +758,15 @@ void SIAFD::compute_diffusivity(bool full_update,
 
   m_D_max = GlobalMax(m_grid->com, D_max);
 
+  {
+    double D_max_global = 0.0;
+    int index = -1;
+    GlobalMaxLoc(m_grid->com, D_max_owned, D_max_index, D_max_global, index);
+
+    m_D_max_i = index >= 0 ? index % static_cast<int>(Mx) : -1;
+    m_D_max_j = index >= 0 ? index / static_cast<int>(Mx) : -1;
+  }
+
   high_diffusivity_counter = GlobalSum(m_grid->com, high_diffusivity_counter);
 
   if (m_D_max > D_limit) {
@@ -73,25 +73,11 @@ double SSAStrengthExtension::get_min_thickness() const {
 
 
 SSA::SSA(IceGrid::ConstPtr g)
-  : ShallowStressBalance(g)
+  : ShallowStressBalance(g),
+    m_mask(g, "ssa_mask", g->ctx()->config()->get_number("grid.max_stencil_width"))
 {
   strength_extension = new SSAStrengthExtension(*m_config);
 
-  const unsigned int WIDE_STENCIL = m_config->get_number("grid.max_stencil_width");
-
-  // grounded_dragging_floating integer mask
-  m_mask.create(m_grid, "ssa_mask", WITH_GHOSTS, WIDE_STENCIL);
-  m_mask.set_attrs("diagnostic", "ice-type (ice-free/grounded/floating/ocean) integer mask",
-                   "", "", "", 0);
-  std::vector<double> mask_values(4);
-  mask_values[0] = MASK_ICE_FREE_BEDROCK;
-  mask_values[1] = MASK_GROUNDED;
-  mask_values[2] = MASK_FLOATING;
-  mask_values[3] = MASK_ICE_FREE_OCEAN;
-  m_mask.metadata().set_numbers("flag_values", mask_values);
-  m_mask.metadata().set_string("flag_meanings",
-                              "ice_free_bedrock grounded_ice floating_ice ice_free_ocean");
-
   m_taud.create(m_grid, "taud", WITHOUT_GHOSTS);
   m_taud.set_attrs("diagnostic",
                    "X-component of the driving shear stress at the base of ice",
@@ -249,7 +235,7 @@ give a lower driving stress. The transformation is not used in floating ice.
  */
 void SSA::compute_driving_stress(const IceModelVec2S &ice_thickness,
                                  const IceModelVec2S &surface_elevation,
-                                 const IceModelVec2CellType &cell_type,
+                                 const CompactMask &cell_type,
                                  const IceModelVec2Int *no_model_mask,
                                  IceModelVec2V &result) const {
 
@@ -301,7 +287,7 @@ void SSA::compute_driving_stress(const IceModelVec2S &ice_thickness,
     //
     // The y derivative is handled the same way.
 
-    auto M = cell_type.int_star(i, j);
+    auto M = cell_type.star(i, j);
     auto h = surface_elevation.star(i, j);
     StarStencil<int> N(0);
 
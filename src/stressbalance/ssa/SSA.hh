@@ -21,6 +21,7 @@
 
 #include "pism/stressbalance/ShallowStressBalance.hh"
 #include "pism/util/IceModelVec2CellType.hh"
+#include "pism/util/CompactMask.hh"
 
 namespace pism {
 
@@ -131,13 +132,14 @@ protected:
 
   virtual void compute_driving_stress(const IceModelVec2S &ice_thickness,
                                       const IceModelVec2S &surface_elevation,
-                                      const IceModelVec2CellType &cell_type,
+                                      const CompactMask &cell_type,
                                       const IceModelVec2Int *no_model_mask,
                                       IceModelVec2V &result) const;
 
   virtual void solve(const Inputs &inputs) = 0;
 
-  IceModelVec2CellType m_mask;
+  //! Cell type mask (one byte per grid point, including ghosts), updated in update().
+  CompactMask m_mask;
   IceModelVec2V m_taud;
 
   std::string m_stdout_ssa;
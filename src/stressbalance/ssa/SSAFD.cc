@@ -283,7 +283,7 @@ void SSAFD::assemble_rhs(const Inputs &inputs) {
   }
 
   if (use_cfbc) {
-    list.add({&thickness, &bed, &surface, &m_mask, &sea_level});
+    list.add({&thickness, &bed, &surface, &sea_level});
   }
 
   if (use_cfbc and melange_back_pressure) {
@@ -304,7 +304,7 @@ void SSAFD::assemble_rhs(const Inputs &inputs) {
     if (use_cfbc) {
       double H_ij = thickness(i,j);
 
-      auto M = m_mask.int_star(i, j);
+      auto M = m_mask.star(i, j);
 
       // Note: this sets velocities at both ice-free ocean and ice-free
       // bedrock to zero. This means that we need to set boundary conditions
@@ -515,7 +515,7 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
   ierr = MatZeroEntries(A);
   PISM_CHK(ierr, "MatZeroEntries");
 
-  IceModelVec::AccessList list{&m_nuH, &tauc, &vel, &m_mask, &bed, &surface};
+  IceModelVec::AccessList list{&m_nuH, &tauc, &vel, &bed, &surface};
 
   if (inputs.bc_values && inputs.bc_mask) {
     list.add(*inputs.bc_mask);
@@ -565,7 +565,7 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
         // be prescribed and is a temperature-independent free (user determined) parameter
 
         // direct neighbors
-        auto M = m_mask.int_star(i, j);
+        auto M = m_mask.star(i, j);
         auto H = thickness.star(i, j);
         auto b = bed.star(i, j);
         double h = surface(i, j);
@@ -612,10 +612,10 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
       int NNW = 1, NNE = 1, SSW = 1, SSE = 1;
       int WNW = 1, ENE = 1, WSW = 1, ESE = 1;
 
-      int M_ij = m_mask.as_int(i,j);
+      int M_ij = m_mask(i, j);
 
       if (use_cfbc) {
-        auto M = m_mask.int_box(i, j);
+        auto M = m_mask.box(i, j);
 
         // Note: this sets velocities at both ice-free ocean and ice-free
         // bedrock to zero. This means that we need to set boundary conditions
@@ -774,7 +774,7 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
         // Set very high basal drag *in the direction along the boundary* at locations
         // bordering "fjord walls".
 
-        auto M = m_mask.int_star(i, j);
+        auto M = m_mask.star(i, j);
         auto b = bed.star(i, j);
         double h = surface(i, j);
 
@@ -1264,9 +1264,9 @@ void SSAFD::compute_hardav_staggered(const Inputs &inputs) {
         const int oi = 1-o, oj=o;
         double H;
 
-        if (m_mask.icy(i,j) && m_mask.icy(i+oi,j+oj)) {
+        if (mask::icy(m_mask(i,j)) && mask::icy(m_mask(i+oi,j+oj))) {
           H = 0.5 * (thickness(i,j) + thickness(i+oi,j+oj));
-        } else if (m_mask.icy(i,j)) {
+        } else if (mask::icy(m_mask(i,j))) {
           H = thickness(i,j);
         }  else {
           H = thickness(i+oi,j+oj);
@@ -1511,7 +1511,7 @@ void SSAFD::compute_nuH_staggered_cfbc(const Geometry &geometry,
 
     // x-derivative, i-offset
     {
-      if (m_mask.icy(i,j) && m_mask.icy(i+1,j)) {
+      if (mask::icy(m_mask(i,j)) && mask::icy(m_mask(i+1,j))) {
         m_work(i,j,U_X) = (uv(i+1,j).u - uv(i,j).u) / dx; // u_x
         m_work(i,j,V_X) = (uv(i+1,j).v - uv(i,j).v) / dx; // v_x
         m_work(i,j,W_I) = 1.0;
@@ -1524,7 +1524,7 @@ void SSAFD::compute_nuH_staggered_cfbc(const Geometry &geometry,
 
     // y-derivative, j-offset
     {
-      if (m_mask.icy(i,j) && m_mask.icy(i,j+1)) {
+      if (mask::icy(m_mask(i,j)) && mask::icy(m_mask(i,j+1))) {
         m_work(i,j,U_Y) = (uv(i,j+1).u - uv(i,j).u) / dy; // u_y
         m_work(i,j,V_Y) = (uv(i,j+1).v - uv(i,j).v) / dy; // v_y
         m_work(i,j,W_J) = 1.0;
@@ -1544,10 +1544,10 @@ void SSAFD::compute_nuH_staggered_cfbc(const Geometry &geometry,
     double u_x, u_y, v_x, v_y, H, nu, W;
     // i-offset
     {
-      if (m_mask.icy(i,j) && m_mask.icy(i+1,j)) {
+      if (mask::icy(m_mask(i,j)) && mask::icy(m_mask(i+1,j))) {
         H = 0.5 * (thickness(i,j) + thickness(i+1,j));
       }
-      else if (m_mask.icy(i,j)) {
+      else if (mask::icy(m_mask(i,j))) {
         H = thickness(i,j);
       } else {
         H = thickness(i+1,j);
@@ -1580,9 +1580,9 @@ void SSAFD::compute_nuH_staggered_cfbc(const Geometry &geometry,
 
     // j-offset
     {
-      if (m_mask.icy(i,j) && m_mask.icy(i,j+1)) {
+      if (mask::icy(m_mask(i,j)) && mask::icy(m_mask(i,j+1))) {
         H = 0.5 * (thickness(i,j) + thickness(i,j+1));
-      } else if (m_mask.icy(i,j)) {
+      } else if (mask::icy(m_mask(i,j))) {
         H = thickness(i,j);
       } else {
         H = thickness(i,j+1);
@@ -1679,8 +1679,6 @@ void SSAFD::set_diagonal_matrix_entry(Mat A, int i, int j, int component,
 
 //! \brief Checks if a cell is near or at the ice front.
 /*!
- * You need to create IceModelVec::AccessList object and add mask to it.
- *
  * Note that a cell is a CFBC location of one of four direct neighbors is ice-free.
  *
  * If one of the diagonal neighbors is ice-free we don't use the CFBC, but we
@@ -1693,7 +1691,7 @@ void SSAFD::set_diagonal_matrix_entry(Mat A, int i, int j, int component,
  */
 bool SSAFD::is_marginal(int i, int j, bool ssa_dirichlet_bc) {
 
-  auto M = m_mask.int_box(i, j);
+  auto M = m_mask.box(i, j);
 
   if (ssa_dirichlet_bc) {
     return icy(M.ij) &&
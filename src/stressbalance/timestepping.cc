@@ -31,6 +31,23 @@ CFLData::CFLData() {
   w_max = 0.0;
 }
 
+/*!
+ * Combine rank-local CFL time step restrictions and the linear indexes (`j * Mx + i`) of
+ * grid points where they are attained.
+ *
+ * The resulting MaxTimestep records the location of the strictest restriction (if any).
+ */
+static MaxTimestep cfl_max_timestep(MPI_Comm com, int Mx, double dt_max, int dt_index) {
+  double dt = 0.0;
+  int index = -1;
+  GlobalMinLoc(com, dt_max, dt_index, dt, index);
+
+  if (index >= 0) {
+    return MaxTimestep(dt, "", index % Mx, index / Mx);
+  }
+  return MaxTimestep(dt);
+}
+
 //! Compute the maximum velocities for time-stepping and reporting to user.
 /*!
 Computes the maximum magnitude of the components \f$u,v,w\f$ of the 3D velocity.
@@ -56,7 +73,11 @@ CFLData max_timestep_cfl_3d(const IceModelVec2S &ice_thickness,
     one_over_dx = 1.0 / grid->dx(),
     one_over_dy = 1.0 / grid->dy();
 
+  const int Mx = grid->Mx();
+
   double u_max = 0.0, v_max = 0.0, w_max = 0.0;
+  // linear index of the grid point limiting the time step
+  int dt_index = -1;
   ParallelSection loop(grid->com);
   try {
     for (Points p(*grid); p; p.next()) {
@@ -76,8 +97,9 @@ CFLData max_timestep_cfl_3d(const IceModelVec2S &ice_thickness,
           u_max = std::max(u_max, u_abs);
           v_max = std::max(v_max, v_abs);
           const double denom = fabs(u_abs * one_over_dx) + fabs(v_abs * one_over_dy);
-          if (denom > 0.0) {
-            dt_max = std::min(dt_max, 1.0 / denom);
+          if (denom > 0.0 and 1.0 / denom < dt_max) {
+            dt_max   = 1.0 / denom;
+            dt_index = j * Mx + i;
           }
         }
 
@@ -96,7 +118,7 @@ CFLData max_timestep_cfl_3d(const IceModelVec2S &ice_thickness,
   result.u_max = GlobalMax(grid->com, u_max);
   result.v_max = GlobalMax(grid->com, v_max);
   result.w_max = GlobalMax(grid->com, w_max);
-  result.dt_max = MaxTimestep(GlobalMin(grid->com, dt_max));
+  result.dt_max = cfl_max_timestep(grid->com, Mx, dt_max, dt_index);
 
   return result;
 }
@@ -124,9 +146,13 @@ CFLData max_timestep_cfl_2d(const IceModelVec2S &ice_thickness,
     dx = grid->dx(),
     dy = grid->dy();
 
+  const int Mx = grid->Mx();
+
   IceModelVec::AccessList list{&velocity, &cell_type};
 
   double u_max = 0.0, v_max = 0.0;
+  // linear index of the grid point limiting the time step
+  int dt_index = -1;
   for (Points p(*grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
@@ -139,8 +165,9 @@ CFLData max_timestep_cfl_2d(const IceModelVec2S &ice_thickness,
       v_max = std::max(v_max, v_abs);
 
       const double denom = u_abs / dx + v_abs / dy;
-      if (denom > 0.0) {
-        dt_max = std::min(dt_max, 1.0 / denom);
+      if (denom > 0.0 and 1.0 / denom < dt_max) {
+        dt_max   = 1.0 / denom;
+        dt_index = j * Mx + i;
       }
     }
   }
@@ -150,7 +177,7 @@ CFLData max_timestep_cfl_2d(const IceModelVec2S &ice_thickness,
   result.u_max = GlobalMax(grid->com, u_max);
   result.v_max = GlobalMax(grid->com, v_max);
   result.w_max = 0.0;
-  result.dt_max = MaxTimestep(GlobalMin(grid->com, dt_max));
+  result.dt_max = cfl_max_timestep(grid->com, Mx, dt_max, dt_index);
 
   return result;
 }
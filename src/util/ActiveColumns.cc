@@ -0,0 +1,88 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/util/ActiveColumns.hh"
+#include "pism/util/IceGrid.hh"
+#include "pism/util/iceModelVec.hh"
+#include "pism/util/IceModelVec2CellType.hh"
+
+namespace pism {
+
+ActiveColumns::ActiveColumns()
+  : m_ice_thickness(NULL),
+    m_cell_type(NULL),
+    m_ice_thickness_counter(-1),
+    m_cell_type_counter(-1) {
+  // empty
+}
+
+//! Re-build lists of icy and ice-free columns if the ice thickness or the cell type changed.
+/*!
+ * If `cell_type` is NULL lists are re-built every time (a change in the ice thickness
+ * does not necessarily increment its state counter).
+ *
+ * Returns `true` if lists were re-built.
+ */
+bool ActiveColumns::update(const IceModelVec2S &ice_thickness,
+                           const IceModelVec2CellType *cell_type) {
+  bool up_to_date = (cell_type != NULL and
+                     &ice_thickness == m_ice_thickness and
+                     cell_type == m_cell_type and
+                     ice_thickness.state_counter() == m_ice_thickness_counter and
+                     cell_type->state_counter() == m_cell_type_counter);
+
+  if (up_to_date) {
+    return false;
+  }
+
+  const IceGrid &grid = *ice_thickness.grid();
+
+  m_icy.clear();
+  m_ice_free.clear();
+
+  IceModelVec::AccessList list(ice_thickness);
+
+  for (Points p(grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    List &result = ice_thickness(i, j) > 0.0 ? m_icy : m_ice_free;
+
+    result.push_back(i);
+    result.push_back(j);
+  }
+
+  m_ice_thickness         = &ice_thickness;
+  m_cell_type             = cell_type;
+  m_ice_thickness_counter = ice_thickness.state_counter();
+  m_cell_type_counter     = cell_type ? cell_type->state_counter() : -1;
+
+  return true;
+}
+
+//! Columns with positive ice thickness.
+const ActiveColumns::List& ActiveColumns::icy() const {
+  return m_icy;
+}
+
+//! Columns with no ice.
+const ActiveColumns::List& ActiveColumns::ice_free() const {
+  return m_ice_free;
+}
+
+} // end of namespace pism
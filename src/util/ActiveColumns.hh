@@ -0,0 +1,111 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_ACTIVECOLUMNS_H
+#define PISM_ACTIVECOLUMNS_H
+
+#include <vector>
+#include <cassert>
+
+namespace pism {
+
+class IceGrid;
+class IceModelVec2S;
+class IceModelVec2CellType;
+
+//! Lists of icy and ice-free grid columns owned by this process.
+/*!
+ * Many 3D kernels loop over all grid points and then skip (or do trivial work in) columns
+ * with no ice. In a typical ice sheet simulation more than half of the domain is
+ * ice-free, so it is beneficial to loop over icy columns only.
+ *
+ * A column is "icy" if the ice thickness is positive.
+ *
+ * Lists are re-built when the state counter of the ice thickness or the cell type mask
+ * changes (see IceModelVec::state_counter()). Geometry::ensure_consistency() increments
+ * both, so these lists are up to date as long as the geometry is consistent.
+ *
+ * Usage:
+ *
+ * \code
+ * m_active_columns.update(ice_thickness, &cell_type);
+ *
+ * for (ColumnPoints p(m_active_columns.icy()); p; p.next()) {
+ *   const int i = p.i(), j = p.j();
+ *   ...
+ * }
+ * \endcode
+ */
+class ActiveColumns {
+public:
+  ActiveColumns();
+
+  //! A list of grid columns. Stores indexes `i` and `j` next to each other.
+  typedef std::vector<int> List;
+
+  bool update(const IceModelVec2S &ice_thickness, const IceModelVec2CellType *cell_type);
+
+  const List& icy() const;
+  const List& ice_free() const;
+private:
+  List m_icy, m_ice_free;
+
+  // identity and state counters of fields used to build lists
+  const IceModelVec2S *m_ice_thickness;
+  const IceModelVec2CellType *m_cell_type;
+  int m_ice_thickness_counter;
+  int m_cell_type_counter;
+};
+
+/** Iterator class for traversing a list of grid columns.
+ *
+ * Usage:
+ *
+ * `for (ColumnPoints p(list); p; p.next()) { ... }`
+ */
+class ColumnPoints {
+public:
+  ColumnPoints(const ActiveColumns::List &list)
+    : m_list(list), m_k(0) {
+    // empty
+  }
+
+  int i() const {
+    return m_list[m_k];
+  }
+  int j() const {
+    return m_list[m_k + 1];
+  }
+
+  void next() {
+    assert(m_k < m_list.size());
+    m_k += 2;
+  }
+
+  operator bool() const {
+    return m_k < m_list.size();
+  }
+private:
+  const ActiveColumns::List &m_list;
+  size_t m_k;
+};
+
+} // end of namespace pism
+
+#endif /* PISM_ACTIVECOLUMNS_H */
@@ -22,6 +22,7 @@
 
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/iceModelVec.hh"
+#include "pism/util/RaggedColumns.hh"
 #include "ColumnSystem.hh"
 
 #include "pism/util/error_handling.hh"
@@ -261,6 +262,8 @@ columnSystemCtx::columnSystemCtx(const std::vector<double>& storage_grid,
   m_u.resize(m_z.size());
   m_v.resize(m_z.size());
   m_w.resize(m_z.size());
+
+  m_coarse.resize(storage_grid.size());
 }
 
 columnSystemCtx::~columnSystemCtx() {
@@ -286,6 +289,13 @@ void columnSystemCtx::fine_to_coarse(const std::vector<double> &fine, int i, int
   m_interp->fine_to_coarse(&fine[0], array);
 }
 
+//! Interpolate to the storage grid, keeping levels stored in the column `(i, j)` of `coarse`.
+void columnSystemCtx::fine_to_coarse(const std::vector<double> &fine, int i, int j,
+                                     RaggedColumns& coarse) {
+  m_interp->fine_to_coarse(&fine[0], &m_coarse[0]);
+  coarse.set_column(i, j, &m_coarse[0]);
+}
+
 void columnSystemCtx::coarse_to_fine(const IceModelVec3 &coarse, int i, int j,
                                      double* fine) const {
   const double *array = coarse.get_column(i, j);
@@ -132,6 +132,7 @@ private:
 };
 
 class IceModelVec3;
+class RaggedColumns;
 class ColumnInterpolation;
 
 //! Base class for tridiagonal systems in the ice.
@@ -153,6 +154,8 @@ public:
   const std::vector<double>& z() const;
   void fine_to_coarse(const std::vector<double> &fine, int i, int j,
                       IceModelVec3& coarse) const;
+  void fine_to_coarse(const std::vector<double> &fine, int i, int j,
+                      RaggedColumns& coarse);
 protected:
   TridiagonalSystem *m_solver;
 
@@ -173,6 +176,8 @@ protected:
   std::vector<double> m_w;
   //! levels of the fine vertical grid
   std::vector<double> m_z;
+  //! storage for one column on the coarse (storage) grid
+  std::vector<double> m_coarse;
 
   //! pointers to 3D velocity components
   const IceModelVec3 &m_u3, &m_v3, &m_w3;
@@ -0,0 +1,233 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <mpi.h>
+#include <petscdmda.h>
+#include <algorithm>          // std::fill
+
+#include "pism/util/CompactMask.hh"
+#include "pism/util/IceGrid.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/iceModelVec.hh"
+
+namespace pism {
+
+struct CompactMask::Impl {
+  IceGrid::ConstPtr grid;
+  std::string name;
+  int stencil_width;
+
+  //! Local patch, including ghosts.
+  std::vector<int8_t> data;
+
+  //! Ranks of neighbors (left, right, bottom, top).
+  int left, right, bottom, top;
+
+  //! Work space used by update_ghosts().
+  std::vector<int8_t> send_buffer, receive_buffer;
+};
+
+CompactMask::CompactMask(IceGrid::ConstPtr grid, const std::string &name,
+                         unsigned int stencil_width)
+  : m_impl(new Impl) {
+
+  m_impl->grid          = grid;
+  m_impl->name          = name;
+  m_impl->stencil_width = stencil_width;
+
+  const int w = stencil_width;
+
+  m_i0 = grid->xs() - w;
+  m_j0 = grid->ys() - w;
+  m_nx = grid->xm() + 2 * w;
+
+  int ny = grid->ym() + 2 * w;
+
+  m_impl->data.resize(m_nx * ny, 0);
+  m_data = m_impl->data.data();
+
+  // Get neighbors from the DMDA to use the same decomposition (and periodic boundary
+  // conditions) as IceModelVecs.
+  {
+    petsc::DM::Ptr dm = grid->get_dm(1, stencil_width);
+
+    const PetscMPIInt *neighbors = NULL;
+    PetscErrorCode ierr = DMDAGetNeighbors(*dm, &neighbors);
+    PISM_CHK(ierr, "DMDAGetNeighbors");
+
+    // neighbors are stored in the "natural" order: (i - 1, j - 1), (i, j - 1), (i + 1, j - 1),
+    // (i - 1, j), (i, j), (i + 1, j), ...
+    m_impl->bottom = neighbors[1];
+    m_impl->left   = neighbors[3];
+    m_impl->right  = neighbors[5];
+    m_impl->top    = neighbors[7];
+  }
+}
+
+CompactMask::~CompactMask() {
+  delete m_impl;
+}
+
+const std::string& CompactMask::get_name() const {
+  return m_impl->name;
+}
+
+unsigned int CompactMask::stencil_width() const {
+  return m_impl->stencil_width;
+}
+
+void CompactMask::begin_access() const {
+  // empty
+}
+
+void CompactMask::end_access() const {
+  // empty
+}
+
+//! Set all values (including ghosts) to `value`.
+void CompactMask::set(int value) {
+  std::fill(m_impl->data.begin(), m_impl->data.end(), static_cast<int8_t>(value));
+}
+
+//! Copy values from `input` and update ghosts.
+void CompactMask::copy_from(const IceModelVec2Int &input) {
+  const IceGrid &grid = *m_impl->grid;
+
+  IceModelVec::AccessList list(input);
+
+  ParallelSection loop(grid.com);
+  try {
+    for (Points p(grid); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      int value = input.as_int(i, j);
+
+      if (value < INT8_MIN or value > INT8_MAX) {
+        throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                      "value %d of %s at (%d, %d) does not fit in %s",
+                                      value, input.get_name().c_str(), i, j,
+                                      m_impl->name.c_str());
+      }
+
+      set(i, j, value);
+    }
+  } catch (...) {
+    loop.failed();
+  }
+  loop.check();
+
+  update_ghosts();
+}
+
+//! Copy values to `output` (and update its ghosts, if any).
+void CompactMask::copy_to(IceModelVec2Int &output) const {
+  IceModelVec::AccessList list(output);
+
+  for (Points p(*m_impl->grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    output(i, j) = (*this)(i, j);
+  }
+
+  output.update_ghosts();
+}
+
+//! Update ghost points.
+/*!
+ * Uses two passes: the first one exchanges columns of ghosts with left and right
+ * neighbors, the second one exchanges rows (including corners filled during the first
+ * pass) with bottom and top neighbors.
+ */
+void CompactMask::update_ghosts() {
+  const int w = m_impl->stencil_width;
+
+  if (w == 0) {
+    return;
+  }
+
+  const IceGrid &grid = *m_impl->grid;
+  MPI_Comm com = grid.com;
+
+  const int
+    xs = grid.xs(),
+    xm = grid.xm(),
+    ys = grid.ys(),
+    ym = grid.ym();
+
+  std::vector<int8_t>
+    &send    = m_impl->send_buffer,
+    &receive = m_impl->receive_buffer;
+
+  // Pack a block [i_start, i_start + n_i) x [j_start, j_start + n_j) into "send".
+  auto pack = [&](int i_start, int n_i, int j_start, int n_j) {
+    send.resize(n_i * n_j);
+    int k = 0;
+    for (int j = j_start; j < j_start + n_j; ++j) {
+      for (int i = i_start; i < i_start + n_i; ++i) {
+        send[k++] = m_data[index(i, j)];
+      }
+    }
+  };
+
+  // Unpack "receive" into a block.
+  auto unpack = [&](int i_start, int n_i, int j_start, int n_j) {
+    int k = 0;
+    for (int j = j_start; j < j_start + n_j; ++j) {
+      for (int i = i_start; i < i_start + n_i; ++i) {
+        m_data[index(i, j)] = receive[k++];
+      }
+    }
+  };
+
+  auto exchange = [&](int destination, int source, int tag) {
+    receive.resize(send.size());
+    int err = MPI_Sendrecv(send.data(), (int)send.size(), MPI_INT8_T, destination, tag,
+                           receive.data(), (int)receive.size(), MPI_INT8_T, source, tag,
+                           com, MPI_STATUS_IGNORE);
+    PISM_C_CHK(err, MPI_SUCCESS, "MPI_Sendrecv");
+  };
+
+  // x-direction (owned rows only)
+  {
+    // send the leftmost owned columns to the left neighbor, receive right ghosts
+    pack(xs, w, ys, ym);
+    exchange(m_impl->left, m_impl->right, 0);
+    unpack(xs + xm, w, ys, ym);
+
+    // send the rightmost owned columns to the right neighbor, receive left ghosts
+    pack(xs + xm - w, w, ys, ym);
+    exchange(m_impl->right, m_impl->left, 1);
+    unpack(xs - w, w, ys, ym);
+  }
+
+  // y-direction (full width, including ghosts in the x direction)
+  {
+    // send the bottom owned rows to the bottom neighbor, receive top ghosts
+    pack(xs - w, xm + 2 * w, ys, w);
+    exchange(m_impl->bottom, m_impl->top, 2);
+    unpack(xs - w, xm + 2 * w, ys + ym, w);
+
+    // send the top owned rows to the top neighbor, receive bottom ghosts
+    pack(xs - w, xm + 2 * w, ys + ym - w, w);
+    exchange(m_impl->top, m_impl->bottom, 3);
+    unpack(xs - w, xm + 2 * w, ys - w, w);
+  }
+}
+
+} // end of namespace pism
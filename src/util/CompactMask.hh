@@ -0,0 +1,133 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_COMPACTMASK_H
+#define PISM_COMPACTMASK_H
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <memory>
+
+#include "pism/util/iceModelVec.hh" // PetscAccessible, BoxStencil, IceModelVec2Int
+#include "pism/util/StarStencil.hh"
+
+namespace pism {
+
+class IceGrid;
+
+//! A 2D integer field using one byte per grid point.
+/*!
+ * IceModelVec2Int stores values as `double` (PETSc Vecs cannot store anything else), so a
+ * mask costs 8 bytes per grid point in memory and in ghost exchanges and every read
+ * involves a conversion. This class stores values as `int8_t` and implements its own
+ * ghost exchange (using the same domain decomposition as the DMDA of the grid).
+ *
+ * It is meant for masks that are used in kernels touching many grid points and do not
+ * need I/O (use IceModelVec2Int for that). Fill it using GeometryCalculator::compute_mask()
+ * (this sets ghosts, too), set() and update_ghosts(), or copy_from(), then access values
+ * using operator(), star() and box(). SSA solvers use it to store the cell type mask.
+ *
+ * Values have to be in the range [-128, 127].
+ *
+ * Instances can be added to an AccessList; begin_access() and end_access() are no-ops.
+ */
+class CompactMask : public PetscAccessible {
+public:
+  CompactMask(std::shared_ptr<const IceGrid> grid, const std::string &name,
+              unsigned int stencil_width = 1);
+  ~CompactMask();
+
+  typedef std::shared_ptr<CompactMask> Ptr;
+  typedef std::shared_ptr<const CompactMask> ConstPtr;
+
+  const std::string& get_name() const;
+  unsigned int stencil_width() const;
+
+  void set(int value);
+
+  void copy_from(const IceModelVec2Int &input);
+  void copy_to(IceModelVec2Int &output) const;
+
+  void update_ghosts();
+
+  void begin_access() const;
+  void end_access() const;
+
+  inline int operator()(int i, int j) const;
+  inline void set(int i, int j, int value);
+  inline StarStencil<int> star(int i, int j) const;
+  inline BoxStencil<int> box(int i, int j) const;
+private:
+  inline int index(int i, int j) const;
+
+  struct Impl;
+  Impl *m_impl;
+
+  // data and the geometry of the local (ghosted) patch, duplicated here to inline accessors
+  int8_t *m_data;
+  int m_i0, m_j0, m_nx;
+
+  // disable copy constructor and the assignment operator:
+  CompactMask(const CompactMask &other);
+  CompactMask& operator=(const CompactMask&);
+};
+
+inline int CompactMask::index(int i, int j) const {
+  return (j - m_j0) * m_nx + (i - m_i0);
+}
+
+inline int CompactMask::operator()(int i, int j) const {
+  return m_data[index(i, j)];
+}
+
+inline void CompactMask::set(int i, int j, int value) {
+  m_data[index(i, j)] = static_cast<int8_t>(value);
+}
+
+inline StarStencil<int> CompactMask::star(int i, int j) const {
+  const CompactMask &m = *this;
+
+  StarStencil<int> result;
+
+  result.ij = m(i,     j);
+  result.e  = m(i + 1, j);
+  result.w  = m(i - 1, j);
+  result.n  = m(i,     j + 1);
+  result.s  = m(i,     j - 1);
+
+  return result;
+}
+
+inline BoxStencil<int> CompactMask::box(int i, int j) const {
+  const CompactMask &m = *this;
+
+  const int
+      E = i + 1,
+      W = i - 1,
+      N = j + 1,
+      S = j - 1;
+
+  return {m(i, j), m(i, N), m(W, N), m(W, j), m(W, S),
+          m(i, S), m(E, S), m(E, j), m(E, N)};
+}
+
+} // end of namespace pism
+
+#endif /* PISM_COMPACTMASK_H */
@@ -187,6 +187,7 @@ TSDiagnostic::TSDiagnostic(IceGrid::ConstPtr g, const std::string &name)
   m_start        = 0;
 
   m_buffer_size = (size_t)m_config->get_number("output.timeseries.buffer_size");
+  m_sync        = m_config->get_flag("output.timeseries.sync");
 
   m_ts.variable().set_string("ancillary_variables", name + "_aux");
 
@@ -312,6 +313,10 @@ void TSRateDiagnostic::evaluate(double t0, double t1, double change) {
 
 void TSDiagnostic::update(double t0, double t1) {
   this->update_impl(t0, t1);
+
+  if (m_ts.times().size() >= m_buffer_size) {
+    flush();
+  }
 }
 
 void TSSnapshotDiagnostic::update_impl(double t0, double t1) {
@@ -343,49 +348,51 @@ void TSFluxDiagnostic::update_impl(double t0, double t1) {
 }
 
 void TSDiagnostic::define(const File &file) const {
+  // define the time coordinate variable first to make sure it gets its attributes
+  io::define_timeseries(m_ts.dimension(), file, PISM_DOUBLE);
   io::define_timeseries(m_ts.variable(), file, PISM_DOUBLE);
   io::define_time_bounds(m_ts.bounds(), file, PISM_DOUBLE);
 }
 
 void TSDiagnostic::flush() {
 
-  if (m_ts.times().empty()) {
+  if (m_ts.times().empty() or not m_output_file) {
     return;
   }
 
-  std::string dimension_name = m_ts.dimension().get_name();
-
-  File file(m_grid->com, m_output_filename, PISM_NETCDF3, PISM_READWRITE); // OK to use netcdf3
-
-  unsigned int len = file.dimension_length(dimension_name);
-
-  if (len > 0) {
-    double last_time = vector_max(file.read_dimension(dimension_name));
-
-    if (last_time < m_ts.times().front()) {
-      m_start = len;
-    }
-  }
+  const File &file = *m_output_file;
 
-  if (len == m_start) {
-    io::write_timeseries(file, m_ts.dimension(), m_start, m_ts.times());
-    io::write_time_bounds(file, m_ts.bounds(), m_start, m_ts.time_bounds());
-  }
+  // All scalar diagnostics share the time dimension and record times at the same
+  // reporting times, so each one writes times and time bounds of its records. This way
+  // we don't need to read the time dimension (which gets long) from the file.
+  io::write_timeseries(file, m_ts.dimension(), m_start, m_ts.times());
+  io::write_time_bounds(file, m_ts.bounds(), m_start, m_ts.time_bounds());
   io::write_timeseries(file, m_ts.variable(), m_start, m_ts.values());
 
   m_start += m_ts.times().size();
 
   m_ts.reset();
+
+  if (m_sync) {
+    file.sync();
+  }
 }
 
-void TSDiagnostic::init(const File &output_file,
+/*!
+ * The output file is kept open (this avoids re-opening it every time buffered values are
+ * written). Variables are defined here to avoid re-defining the file later.
+ */
+void TSDiagnostic::init(std::shared_ptr<File> output_file,
                         std::shared_ptr<std::vector<double>> requested_times) {
-  m_output_filename = output_file.filename();
+  m_output_file = output_file;
 
   m_times = requested_times;
 
-  // Get the number of records in the file (for appending):
-  m_start = output_file.dimension_length(m_ts.dimension().get_name());
+  define(*m_output_file);
+
+  // Get the number of records in the file (for appending). flush() keeps track of records
+  // written after this.
+  m_start = m_output_file->dimension_length(m_ts.dimension().get_name());
 }
 
 const VariableMetadata &TSDiagnostic::metadata() const {
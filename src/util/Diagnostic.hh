@@ -277,7 +277,7 @@ public:
 
   void flush();
 
-  void init(const File &output_file,
+  void init(std::shared_ptr<File> output_file,
             std::shared_ptr<std::vector<double>> requested_times);
 
   const VariableMetadata &metadata() const;
@@ -316,13 +316,15 @@ protected:
   //! index into m_times
   unsigned int m_current_time;
 
-  //! the name of the file to save to (stored here because it is used by flush(), which is called
-  //! from update())
-  std::string m_output_filename;
-  //! starting index used when flushing the buffer
+  //! the file to save to (kept open for the duration of the run and shared by all scalar
+  //! diagnostics; stored here because it is used by flush(), which is called from update())
+  std::shared_ptr<File> m_output_file;
+  //! number of records in the output file (starting index used when flushing the buffer)
   unsigned int m_start;
-  //! size of the buffer used to store data
+  //! size of the buffer used to store data (flush() is called when it is full)
   size_t m_buffer_size;
+  //! if true, sync the output file after writing buffered data
+  bool m_sync;
 };
 
 typedef std::map<std::string, TSDiagnostic::Ptr> TSDiagnosticList;
@@ -19,6 +19,7 @@
 #include <cassert>
 
 #include <map>
+#include <algorithm>
 #include <numeric>
 #include <petscsys.h>
 #include <gsl/gsl_interp.h>
@@ -34,6 +35,7 @@
 #include "pism/util/Vars.hh"
 #include "pism/util/Logger.hh"
 #include "pism/util/projection.hh"
+#include "pism/util/iceModelVec.hh"
 #include "pism/pism_config.hh"
 
 #if (Pism_USE_PIO==1)
@@ -1333,6 +1335,214 @@ void GridParameters::validate() const {
   }
 }
 
+//! Compute ownership ranges in one direction using `weights` (the expected work load
+//! corresponding to each grid row or column).
+/*!
+ * Splits `weights` into `N` contiguous parts with (approximately) equal total weight. Each
+ * part has at least `min_width` grid points.
+ */
+static std::vector<unsigned int> weighted_ownership_ranges(const std::vector<double> &weights,
+                                                           unsigned int N,
+                                                           unsigned int min_width) {
+  const unsigned int M = weights.size();
+
+  double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+
+  if (not (total > 0.0) or M < N * min_width) {
+    return ownership_ranges(M, N);
+  }
+
+  std::vector<unsigned int> result(N);
+
+  unsigned int start = 0;
+  double cumulative = 0.0;
+  for (unsigned int k = 0; k < N - 1; ++k) {
+    double target = (k + 1) * total / N;
+
+    // leave at least min_width points for each of the remaining parts
+    unsigned int end_max = M - (N - k - 1) * min_width;
+
+    unsigned int end = start;
+    while (end < end_max and
+           (end - start < min_width or cumulative + 0.5 * weights[end] <= target)) {
+      cumulative += weights[end];
+      end += 1;
+    }
+
+    result[k] = end - start;
+    start = end;
+  }
+  result[N - 1] = M - start;
+
+  return result;
+}
+
+//! Compute the ratio of the maximum sub-domain work load to the mean.
+/*!
+ * @param[in] weights work load of each grid column
+ * @param[in] procs_x ownership ranges in the x direction
+ * @param[in] procs_y ownership ranges in the y direction
+ */
+static double load_imbalance(const IceModelVec2S &weights,
+                             const std::vector<unsigned int> &procs_x,
+                             const std::vector<unsigned int> &procs_y) {
+  const IceGrid &grid = *weights.grid();
+
+  // indexes of sub-domains containing each grid row and column
+  std::vector<unsigned int> block_x, block_y;
+  for (unsigned int k = 0; k < procs_x.size(); ++k) {
+    block_x.insert(block_x.end(), procs_x[k], k);
+  }
+  for (unsigned int k = 0; k < procs_y.size(); ++k) {
+    block_y.insert(block_y.end(), procs_y[k], k);
+  }
+
+  const unsigned int Nx = procs_x.size();
+  std::vector<double> load(Nx * procs_y.size(), 0.0);
+
+  IceModelVec::AccessList list(weights);
+
+  for (Points p(grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    load[block_y[j] * Nx + block_x[i]] += weights(i, j);
+  }
+
+  int err = MPI_Allreduce(MPI_IN_PLACE, load.data(), (int)load.size(),
+                          MPI_DOUBLE, MPI_SUM, grid.com);
+  PISM_C_CHK(err, 0, "MPI_Allreduce");
+
+  double total = std::accumulate(load.begin(), load.end(), 0.0);
+  if (not (total > 0.0)) {
+    return 1.0;
+  }
+
+  double max_load = *std::max_element(load.begin(), load.end());
+
+  return max_load / (total / load.size());
+}
+
+//! Re-create `grid` using ownership ranges that balance the expected work load.
+/*!
+ * The work load of a grid column is estimated using the ice thickness in `file`: an
+ * ice-free column costs `grid.load_balancing.ice_free_weight`, an icy column costs `1 +
+ * ks / Mz`, where `ks` is the number of vertical levels in the ice.
+ *
+ * The number of sub-domains in each direction is not changed; only their sizes are. (The
+ * PETSc DMDA used by PISM requires a tensor-product decomposition.)
+ *
+ * Returns `grid` itself if load balancing is disabled, the user set ownership ranges
+ * using `-procs_x` and `-procs_y` or the run uses one MPI process.
+ */
+static IceGrid::Ptr balance_load(IceGrid::Ptr grid, const File &file) {
+  Context::ConstPtr ctx = grid->ctx();
+  Config::ConstPtr config = ctx->config();
+
+  if (not config->get_flag("grid.load_balancing.enabled") or grid->size() == 1) {
+    return grid;
+  }
+
+  {
+    options::IntegerList procs_x("-procs_x", "Processor ownership ranges (x direction)", {});
+    options::IntegerList procs_y("-procs_y", "Processor ownership ranges (y direction)", {});
+    if (procs_x.is_set() or procs_y.is_set()) {
+      return grid;
+    }
+  }
+
+  const unsigned int
+    Mx = grid->Mx(),
+    My = grid->My(),
+    Mz = grid->Mz();
+
+  const double ice_free_weight = config->get_number("grid.load_balancing.ice_free_weight");
+
+  // Compute the work load of each grid column and its sums along grid rows and columns.
+  IceModelVec2S weights;
+  weights.create(grid, "thk", WITHOUT_GHOSTS);
+  weights.set_attrs("internal", "land ice thickness",
+                    "m", "m", "land_ice_thickness", 0);
+  weights.regrid(file, OPTIONAL, 0.0);
+
+  std::vector<double> weights_x(Mx, 0.0), weights_y(My, 0.0);
+  {
+    IceModelVec::AccessList list(weights);
+
+    for (Points p(*grid); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      double H = weights(i, j);
+
+      if (H > 0.0) {
+        double ks = grid->kBelowHeight(std::min(H, grid->Lz()));
+        weights(i, j) = 1.0 + ks / Mz;
+      } else {
+        weights(i, j) = ice_free_weight;
+      }
+
+      weights_x[i] += weights(i, j);
+      weights_y[j] += weights(i, j);
+    }
+
+    int err = MPI_Allreduce(MPI_IN_PLACE, weights_x.data(), (int)Mx,
+                            MPI_DOUBLE, MPI_SUM, grid->com);
+    PISM_C_CHK(err, 0, "MPI_Allreduce");
+
+    err = MPI_Allreduce(MPI_IN_PLACE, weights_y.data(), (int)My,
+                        MPI_DOUBLE, MPI_SUM, grid->com);
+    PISM_C_CHK(err, 0, "MPI_Allreduce");
+  }
+
+  GridParameters p;
+  p.Lx           = grid->Lx();
+  p.Ly           = grid->Ly();
+  p.x0           = grid->x0();
+  p.y0           = grid->y0();
+  p.Mx           = Mx;
+  p.My           = My;
+  p.registration = grid->registration();
+  p.periodicity  = grid->periodicity();
+  p.z            = grid->z();
+
+  // Keep the number of sub-domains in each direction.
+  unsigned int Nx = 0, Ny = 0;
+  {
+    petsc::DM::Ptr da = grid->get_dm(1, 0);
+
+    PetscInt n_x = 0, n_y = 0;
+    PetscErrorCode ierr = DMDAGetInfo(*da, NULL, NULL, NULL, NULL, &n_x, &n_y, NULL,
+                                      NULL, NULL, NULL, NULL, NULL, NULL);
+    PISM_CHK(ierr, "DMDAGetInfo");
+
+    Nx = n_x;
+    Ny = n_y;
+  }
+
+  const unsigned int min_width = std::max(2, (int)config->get_number("grid.max_stencil_width"));
+
+  p.procs_x = weighted_ownership_ranges(weights_x, Nx, min_width);
+  p.procs_y = weighted_ownership_ranges(weights_y, Ny, min_width);
+
+  double
+    imbalance_uniform  = load_imbalance(weights, ownership_ranges(Mx, Nx), ownership_ranges(My, Ny)),
+    imbalance_balanced = load_imbalance(weights, p.procs_x, p.procs_y);
+
+  Logger::ConstPtr log = ctx->log();
+
+  if (imbalance_balanced >= imbalance_uniform) {
+    log->message(2,
+                 "* Load balancing: keeping the uniform domain decomposition"
+                 " (max/mean work load: %.2f)\n", imbalance_uniform);
+    return grid;
+  }
+
+  log->message(2,
+               "* Load balancing: max/mean work load %.2f (uniform decomposition: %.2f)\n",
+               imbalance_balanced, imbalance_uniform);
+
+  return IceGrid::Ptr(new IceGrid(ctx, p));
+}
+
 //! Create a grid using command-line options and (possibly) an input file.
 /** Processes options -i, -bootstrap, -Mx, -My, -Mz, -Lx, -Ly, -Lz, -x_range, -y_range.
  */
@@ -1359,7 +1569,11 @@ IceGrid::Ptr IceGrid::FromOptions(Context::ConstPtr ctx) {
     options::ignored(*log, "-z_spacing");
 
     // get grid from a PISM input file
-    return IceGrid::FromFile(ctx, input_file, {"enthalpy", "temp"}, r);
+    IceGrid::Ptr result = IceGrid::FromFile(ctx, input_file, {"enthalpy", "temp"}, r);
+
+    File file(ctx->com(), input_file, PISM_NETCDF3, PISM_READONLY);
+
+    return balance_load(result, file);
   } else if (not input_file.empty() and bootstrap) {
     // bootstrapping; get domain size defaults from an input file, allow overriding all grid
     // parameters using command-line options
@@ -1398,7 +1612,7 @@ IceGrid::Ptr IceGrid::FromOptions(Context::ConstPtr ctx) {
     input_grid.vertical_grid_from_options(config);
     input_grid.ownership_ranges_from_options(ctx->size());
 
-    IceGrid::Ptr result(new IceGrid(ctx, input_grid));
+    IceGrid::Ptr result = balance_load(IceGrid::Ptr(new IceGrid(ctx, input_grid)), file);
 
     units::System::Ptr sys = ctx->unit_system();
     units::Converter km(sys, "m", "km");
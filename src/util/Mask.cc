@@ -20,6 +20,7 @@
 
 #include "Mask.hh"
 #include "IceGrid.hh"
+#include "CompactMask.hh"
 
 namespace pism {
 
@@ -52,6 +53,27 @@ void GeometryCalculator::compute_mask(const IceModelVec2S &sea_level,
   }
 }
 
+//! Compute the cell type mask, including ghosts (no ghost exchange is needed).
+void GeometryCalculator::compute_mask(const IceModelVec2S &sea_level,
+                                      const IceModelVec2S &bed,
+                                      const IceModelVec2S &thickness,
+                                      CompactMask &result) const {
+  IceModelVec::AccessList list{&sea_level, &bed, &thickness, &result};
+
+  const IceGrid &grid = *bed.grid();
+
+  const unsigned int stencil = result.stencil_width();
+  assert(sea_level.stencil_width() >= stencil);
+  assert(bed.stencil_width()       >= stencil);
+  assert(thickness.stencil_width() >= stencil);
+
+  for (PointsWithGhosts p(grid, stencil); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    result.set(i, j, this->mask(sea_level(i, j), bed(i, j), thickness(i, j)));
+  }
+}
+
 void GeometryCalculator::compute_surface(const IceModelVec2S &sea_level,
                                          const IceModelVec2S &bed,
                                          const IceModelVec2S &thickness,
@@ -26,6 +26,8 @@
 
 namespace pism {
 
+class CompactMask;
+
 enum MaskValue {
   MASK_UNKNOWN          = -1,
   MASK_ICE_FREE_BEDROCK = 0,
@@ -90,6 +92,9 @@ public:
   void compute_mask(const IceModelVec2S& sea_level, const IceModelVec2S& bed,
                     const IceModelVec2S& thickness, IceModelVec2Int& result) const;
 
+  void compute_mask(const IceModelVec2S& sea_level, const IceModelVec2S& bed,
+                    const IceModelVec2S& thickness, CompactMask& result) const;
+
   void compute_surface(const IceModelVec2S& sea_level, const IceModelVec2S& bed,
                        const IceModelVec2S& thickness, IceModelVec2S& result) const;
 
@@ -23,22 +23,27 @@ namespace pism {
 
 // Time step restrictions
 MaxTimestep::MaxTimestep()
-  : m_finite(false), m_value(0.0) {
+  : m_finite(false), m_value(0.0), m_i(-1), m_j(-1) {
   // empty
 }
 
 MaxTimestep::MaxTimestep(double v)
-  : m_finite(true), m_value(v) {
+  : m_finite(true), m_value(v), m_i(-1), m_j(-1) {
   // empty
 }
 
 MaxTimestep::MaxTimestep(const std::string &new_description)
-  : m_finite(false), m_value(0.0), m_description(new_description) {
+  : m_finite(false), m_value(0.0), m_description(new_description), m_i(-1), m_j(-1) {
   // empty
 }
 
 MaxTimestep::MaxTimestep(double v, const std::string &new_description)
-  : m_finite(true), m_value(v), m_description(new_description) {
+  : m_finite(true), m_value(v), m_description(new_description), m_i(-1), m_j(-1) {
+  // empty
+}
+
+MaxTimestep::MaxTimestep(double v, const std::string &new_description, int i, int j)
+  : m_finite(true), m_value(v), m_description(new_description), m_i(i), m_j(j) {
   // empty
 }
 
@@ -58,6 +63,18 @@ std::string MaxTimestep::description() const {
   return m_description;
 }
 
+bool MaxTimestep::has_location() const {
+  return m_i >= 0 and m_j >= 0;
+}
+
+int MaxTimestep::i() const {
+  return m_i;
+}
+
+int MaxTimestep::j() const {
+  return m_j;
+}
+
 bool operator==(const MaxTimestep &a, const MaxTimestep &b) {
   if (a.finite() and b.finite()) {
     return a.value() == b.value();
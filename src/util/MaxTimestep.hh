@@ -39,6 +39,9 @@ public:
   MaxTimestep(const std::string &new_description);
   //! Create an instance and provide a description.
   MaxTimestep(double value, const std::string &new_description);
+  //! Create an instance and provide a description and the grid location (i, j) that
+  //! limited the time step.
+  MaxTimestep(double value, const std::string &new_description, int i, int j);
   //! Convert to `bool` to check if a time step restriction is "active".
   bool finite() const;
   bool infinite() const;
@@ -47,10 +50,17 @@ public:
   double value() const;
 
   std::string description() const;
+
+  //! Check if the grid location that limited the time step is known.
+  bool has_location() const;
+  int i() const;
+  int j() const;
 private:
   bool m_finite;
   double m_value;
   std::string m_description;
+  //! grid location that limited the time step (negative if not known)
+  int m_i, m_j;
 };
 
 //! Greater than operator for MaxTimestep.
@@ -0,0 +1,189 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>            // std::fill, std::min, std::copy
+
+#include "pism/util/RaggedColumns.hh"
+#include "pism/util/IceGrid.hh"
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+
+struct RaggedColumns::Impl {
+  IceGrid::ConstPtr grid;
+  std::string name;
+
+  //! Offsets of columns in `data`; has `xm * ym + 1` elements.
+  std::vector<size_t> offset;
+  std::vector<double> data;
+};
+
+RaggedColumns::RaggedColumns(IceGrid::ConstPtr grid, const std::string &name)
+  : m_impl(new Impl) {
+
+  m_impl->grid = grid;
+  m_impl->name = name;
+
+  m_xs = grid->xs();
+  m_ys = grid->ys();
+  m_xm = grid->xm();
+
+  // Start with one level per column.
+  const size_t N = grid->xm() * grid->ym();
+  m_impl->offset.resize(N + 1);
+  for (size_t k = 0; k <= N; ++k) {
+    m_impl->offset[k] = k;
+  }
+  m_impl->data.resize(N, 0.0);
+
+  m_offset = m_impl->offset.data();
+  m_data   = m_impl->data.data();
+}
+
+RaggedColumns::~RaggedColumns() {
+  delete m_impl;
+}
+
+const std::string& RaggedColumns::get_name() const {
+  return m_impl->name;
+}
+
+void RaggedColumns::begin_access() const {
+  // empty
+}
+
+void RaggedColumns::end_access() const {
+  // empty
+}
+
+//! Total number of values stored by this process.
+size_t RaggedColumns::size() const {
+  return m_impl->data.size();
+}
+
+//! Re-compute the number of levels in each column using `ice_thickness`.
+/*!
+ * Preserves values at levels that remain in the ice. New levels are filled with the value
+ * at the top of the old column (or `fill_value` if the column is empty).
+ */
+void RaggedColumns::update_columns(const IceModelVec2S &ice_thickness, double fill_value) {
+  const IceGrid &grid = *m_impl->grid;
+
+  const double Lz = grid.Lz();
+
+  std::vector<size_t> offset(m_impl->offset.size());
+
+  IceModelVec::AccessList list(ice_thickness);
+
+  offset[0] = 0;
+  for (Points p(grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    const int k = index(i, j);
+
+    const double H = std::max(std::min(ice_thickness(i, j), Lz), 0.0);
+
+    offset[k + 1] = offset[k] + grid.kBelowHeight(H) + 1;
+  }
+
+  std::vector<double> data(offset.back());
+
+  for (Points p(grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    const int k = index(i, j);
+
+    const size_t
+      n_old = m_offset[k + 1] - m_offset[k],
+      n_new = offset[k + 1] - offset[k],
+      n     = std::min(n_old, n_new);
+
+    const double *old_column = m_data + m_offset[k];
+    double *new_column = &data[offset[k]];
+
+    std::copy(old_column, old_column + n, new_column);
+
+    const double top = n_old > 0 ? old_column[n_old - 1] : fill_value;
+    std::fill(new_column + n, new_column + n_new, top);
+  }
+
+  m_impl->offset.swap(offset);
+  m_impl->data.swap(data);
+
+  m_offset = m_impl->offset.data();
+  m_data   = m_impl->data.data();
+}
+
+//! Set all stored values to `value`.
+void RaggedColumns::set(double value) {
+  std::fill(m_impl->data.begin(), m_impl->data.end(), value);
+}
+
+void RaggedColumns::set_column(int i, int j, double c) {
+  double *column = get_column(i, j);
+  std::fill(column, column + n_levels(i, j), c);
+}
+
+//! Set values in the column `(i, j)`. `input` has to have at least `n_levels(i, j)` elements.
+void RaggedColumns::set_column(int i, int j, const double *input) {
+  std::copy(input, input + n_levels(i, j), get_column(i, j));
+}
+
+//! Copy stored levels from `input`.
+void RaggedColumns::copy_from(const IceModelVec3 &input) {
+  const IceGrid &grid = *m_impl->grid;
+
+  if (input.grid()->Mz() != grid.Mz()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "%s and %s have different numbers of vertical levels",
+                                  input.get_name().c_str(), m_impl->name.c_str());
+  }
+
+  IceModelVec::AccessList list(input);
+
+  for (Points p(grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    set_column(i, j, input.get_column(i, j));
+  }
+}
+
+//! Copy to `output`, filling levels above the ice with `fill_value`.
+void RaggedColumns::copy_to(IceModelVec3 &output, double fill_value) const {
+  const IceGrid &grid = *m_impl->grid;
+
+  const unsigned int Mz = grid.Mz();
+
+  IceModelVec::AccessList list(output);
+
+  for (Points p(grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    const unsigned int n = n_levels(i, j);
+    const double *column = get_column(i, j);
+    double *result = output.get_column(i, j);
+
+    std::copy(column, column + n, result);
+    std::fill(result + n, result + Mz, fill_value);
+  }
+
+  output.update_ghosts();
+}
+
+} // end of namespace pism
@@ -0,0 +1,114 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_RAGGEDCOLUMNS_H
+#define PISM_RAGGEDCOLUMNS_H
+
+#include <vector>
+#include <string>
+#include <memory>
+
+#include "pism/util/iceModelVec.hh" // PetscAccessible, IceModelVec2S, IceModelVec3
+
+namespace pism {
+
+class IceGrid;
+
+//! A 3D field storing only levels in the ice.
+/*!
+ * IceModelVec3 stores `Mz` levels in each column, even if the ice is a few meters thick
+ * or absent. This class stores `n_levels(i, j) = kBelowHeight(H) + 1` levels in a column
+ * `(i, j)`, using a table of offsets into one contiguous array. This saves memory and
+ * bandwidth in 3D computations on grids with thin ice or large ice-free areas.
+ *
+ * It does not have ghosts and does not support I/O; use copy_from() and copy_to() to
+ * convert to and from IceModelVec3.
+ *
+ * Call update_columns() after the ice thickness changes. This preserves values at levels
+ * that remain in the ice and fills new levels with the value at the top of the column.
+ *
+ * Instances can be added to an AccessList; begin_access() and end_access() are no-ops.
+ */
+class RaggedColumns : public PetscAccessible {
+public:
+  RaggedColumns(std::shared_ptr<const IceGrid> grid, const std::string &name);
+  ~RaggedColumns();
+
+  typedef std::shared_ptr<RaggedColumns> Ptr;
+  typedef std::shared_ptr<const RaggedColumns> ConstPtr;
+
+  const std::string& get_name() const;
+
+  void update_columns(const IceModelVec2S &ice_thickness, double fill_value);
+
+  void set(double value);
+
+  void copy_from(const IceModelVec3 &input);
+  void copy_to(IceModelVec3 &output, double fill_value) const;
+
+  size_t size() const;
+
+  void begin_access() const;
+  void end_access() const;
+
+  inline unsigned int n_levels(int i, int j) const;
+
+  inline double* get_column(int i, int j);
+  inline const double* get_column(int i, int j) const;
+
+  void set_column(int i, int j, double c);
+  void set_column(int i, int j, const double *input);
+private:
+  inline int index(int i, int j) const;
+
+  struct Impl;
+  Impl *m_impl;
+
+  // Start of each column in m_data (and the total size at the end), duplicated here to
+  // inline accessors
+  size_t *m_offset;
+  double *m_data;
+  int m_xs, m_ys, m_xm;
+
+  // disable copy constructor and the assignment operator:
+  RaggedColumns(const RaggedColumns &other);
+  RaggedColumns& operator=(const RaggedColumns&);
+};
+
+inline int RaggedColumns::index(int i, int j) const {
+  return (j - m_ys) * m_xm + (i - m_xs);
+}
+
+//! Number of levels stored in the column `(i, j)`.
+inline unsigned int RaggedColumns::n_levels(int i, int j) const {
+  const int k = index(i, j);
+  return m_offset[k + 1] - m_offset[k];
+}
+
+inline double* RaggedColumns::get_column(int i, int j) {
+  return m_data + m_offset[index(i, j)];
+}
+
+inline const double* RaggedColumns::get_column(int i, int j) const {
+  return m_data + m_offset[index(i, j)];
+}
+
+} // end of namespace pism
+
+#endif /* PISM_RAGGEDCOLUMNS_H */
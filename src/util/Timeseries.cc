@@ -54,6 +54,7 @@ void Timeseries::private_constructor(MPI_Comm c, const std::string &dimension_na
   m_dimension.set_string("bounds", dimension_name + "_bounds");
 
   m_use_bounds = true;
+  m_cursor = 0;
 }
 
 //! Ensure that time bounds have the same units as the dimension.
@@ -217,7 +218,7 @@ double Timeseries::operator()(double t) const {
     } else if (t >= m_time.back()) {
       k = m_time.size() - 1;
     } else {
-      k = gsl_interp_bsearch(m_time.data(), t, 0, m_time.size()) + 1;
+      k = find(t) + 1;
     }
 
     return m_values[k];
@@ -229,7 +230,7 @@ double Timeseries::operator()(double t) const {
       return m_values[0];
     }
 
-    size_t k = gsl_interp_bsearch(m_time.data(), t, 0, m_time.size());
+    size_t k = find(t);
 
     // extrapolation on the right
     if (k + 1 >= m_time.size()) {
@@ -242,6 +243,29 @@ double Timeseries::operator()(double t) const {
   }
 }
 
+//! Find `k` such that `m_time[k] <= t < m_time[k + 1]`.
+/*!
+  Returns the same index as `gsl_interp_bsearch(m_time.data(), t, 0, m_time.size())`.
+
+  Forcing is usually requested at times that increase monotonically, so this checks the
+  interval found during the previous call and the one after it before falling back to the
+  binary search.
+ */
+size_t Timeseries::find(double t) const {
+  const size_t N = m_time.size();
+
+  for (size_t k = m_cursor; k < std::min(m_cursor + 2, N); ++k) {
+    if (m_time[k] <= t and (k + 1 == N or t < m_time[k + 1])) {
+      m_cursor = k;
+      return k;
+    }
+  }
+
+  m_cursor = gsl_interp_bsearch(m_time.data(), t, 0, N);
+
+  return m_cursor;
+}
+
 //! Get a value of timeseries by index.
 /*!
   Stops if the index is out of range.
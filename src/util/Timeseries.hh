@@ -118,6 +118,10 @@ private:
   std::vector<double> m_values;
   std::vector<double> m_time_bounds;
 
+  //! index of the interval containing the time used in the last call of find()
+  mutable size_t m_cursor;
+  size_t find(double t) const;
+
   void set_bounds_units();
   void private_constructor(MPI_Comm com, const std::string &dimension_name);
   void report_range(const Logger &log);
@@ -18,6 +18,7 @@
 
 #include <petsc.h>
 #include <cassert>
+#include <algorithm>             // std::min
 
 #include "iceModelVec2T.hh"
 #include "pism/util/io/File.hh"
@@ -102,6 +103,13 @@ IceModelVec2T::IceModelVec2T(IceGrid::ConstPtr grid, const std::string &short_na
     m_n_evaluations_per_year(n_evaluations_per_year),
     m_first(-1),
     m_interp_type(interpolation_type),
+    m_interp_first(-1),
+    m_interp_N(0),
+    m_average_start(0),
+    m_average_end(0),
+    m_current_record(-1),
+    m_current_average(false),
+    m_current_counter(-1),
     m_period(0),
     m_reference_time(0.0)
 {
@@ -173,6 +181,10 @@ void IceModelVec2T::init(const std::string &fname, unsigned int period, double r
   m_period         = period;
   m_reference_time = reference_time;
 
+  // times of records may change: discard cached interpolation weights
+  m_interp.reset();
+  discard_current();
+
   // We find the variable in the input file and
   // try to find the corresponding time dimension.
 
@@ -279,6 +291,9 @@ void IceModelVec2T::init_constant(double value) {
   m_N = 1;
   m_first = 0;
 
+  m_interp.reset();
+  discard_current();
+
   // set fake time bounds:
   m_time_bounds = {-1.0, 1.0};
 }
@@ -373,6 +388,9 @@ void IceModelVec2T::update(unsigned int start) {
 
   m_N = kept + missing;
 
+  // reading overwrites the 2D field (see below)
+  discard_current();
+
   Time::ConstPtr t = m_grid->ctx()->time();
 
   Logger::ConstPtr log = m_grid->ctx()->log();
@@ -486,6 +504,9 @@ MaxTimestep IceModelVec2T::max_timestep(double t) const {
  *
  * \note This method does not check if an update() call is necessary!
  *
+ * Increments the state counter only if the record used changes, so callers can use
+ * state_counter() to detect changes in the active forcing record.
+ *
  * @param[in] t requested time
  *
  */
@@ -493,13 +514,43 @@ void IceModelVec2T::interp(double t) {
 
   init_interpolation({t});
 
-  get_record(m_interp->left(0));
+  use_record(m_interp->left(0));
+}
+
+//! Copy the record `n` (an index into the buffer) to the 2D field unless it is already
+//! there.
+void IceModelVec2T::use_record(unsigned int n) {
+  const int record = m_first + n;
+  if (record == m_current_record and state_counter() == m_current_counter) {
+    return;
+  }
+
+  get_record(n);
+
+  inc_state_counter();          // mark as modified
+
+  m_current_record  = record;
+  m_current_average = false;
+  m_current_counter = state_counter();
+}
+
+//! Forget which values are stored in the 2D field.
+void IceModelVec2T::discard_current() {
+  m_current_record  = -1;
+  m_current_average = false;
 }
 
 
 /**
  * Compute the average value over the time interval `[t, t + dt]`.
  *
+ * Does nothing (and does not increment the state counter) if the 2D field already
+ * contains the average computed using the same records and weights.
+ *
+ * \note Values written using operator() do not increment the state counter, so callers
+ * must not modify the 2D field in place: a later call may leave these changes in place.
+ * Copy the result to a separate field instead.
+ *
  * @param t  start of the time interval, in seconds
  * @param dt length of the time interval, in seconds
  *
@@ -528,18 +579,39 @@ void IceModelVec2T::average(double t, double dt) {
 
   init_interpolation(ts);
 
+  // if only one record contributes (its weight is 1) the average is equal to this record
+  if (m_average_end == m_average_start + 1) {
+    use_record(m_average_start);
+    return;
+  }
+
+  // do nothing if the 2D field already contains this average
+  if (m_current_average and state_counter() == m_current_counter) {
+    return;
+  }
+
   double **a2 = get_array();         // calls begin_access()
   for (Points p(*m_grid); p; p.next()) {
     const int i = p.i(), j = p.j();
     a2[j][i] = average(i, j);
   }
   end_access();
+
+  inc_state_counter();          // mark as modified
+
+  m_current_record  = -1;
+  m_current_average = true;
+  m_current_counter = state_counter();
 }
 
 /**
  * \brief Compute weights for the piecewise-constant interpolation.
  * This is used *both* for time-series and "snapshots".
  *
+ * Weights depend on the records in memory and on requested times only, so they are
+ * re-used if this method is called again with the same times and the same records (for
+ * example when several models request the same time-series during a time step).
+ *
  * @param ts requested times, in seconds
  *
  */
@@ -559,9 +631,48 @@ void IceModelVec2T::init_interpolation(const std::vector<double> &ts) {
     times_requested = ts;
   }
 
+  if (m_interp and
+      m_interp_first == m_first and
+      m_interp_N == m_N and
+      m_interp_times == times_requested) {
+    return;
+  }
+
   m_interp.reset(new Interpolation(m_interp_type, &m_time[m_first], m_N,
                                    times_requested.data(), times_requested.size(),
                                    time->years_to_seconds(m_period)));
+
+  m_interp_first = m_first;
+  m_interp_N     = m_N;
+  m_interp_times = times_requested;
+
+  // averages computed using old weights are out of date
+  m_current_average = false;
+
+  // Combine interpolation weights into weights used to compute averages over requested
+  // times: the average at a grid point is then a dot product of these weights with
+  // records stored at this point. Only the range [m_average_start, m_average_end) of
+  // records contributes to averages.
+  {
+    const unsigned int M = times_requested.size();
+
+    m_average_weights.assign(m_N, 0.0);
+    for (unsigned int k = 0; k < M; ++k) {
+      const double alpha = m_interp->alpha(k);
+
+      m_average_weights[m_interp->left(k)]  += (1.0 - alpha) / M;
+      m_average_weights[m_interp->right(k)] += alpha / M;
+    }
+
+    m_average_start = m_N;
+    m_average_end   = 0;
+    for (unsigned int r = 0; r < m_N; ++r) {
+      if (m_average_weights[r] != 0.0) {
+        m_average_start = std::min(m_average_start, r);
+        m_average_end   = r + 1;
+      }
+    }
+  }
 }
 
 /**
@@ -583,27 +694,20 @@ void IceModelVec2T::interp(int i, int j, std::vector<double> &result) {
 //! \brief Finds the average value at i,j over the interval (t, t +
 //! dt) using the rectangle rule.
 /*!
-  Can (and should) be optimized. Later, though.
+  Uses weights precomputed by init_interpolation(), so the cost does not depend on the
+  number of evaluations per year.
  */
 double IceModelVec2T::average(int i, int j) {
-  unsigned int M = m_interp->alpha().size();
-  double result = 0.0;
+  double ***a3 = (double***) m_array3;
+  const double *values = a3[j][i];
 
   if (m_N == 1) {
-    double ***a3 = (double***) m_array3;
-    result = a3[j][i][0];
-  } else {
-    std::vector<double> values(M);
-
-    interp(i, j, values);
+    return values[0];
+  }
 
-    // rectangular rule (uses the fact that points are equally-spaced
-    // in time)
-    result = 0;
-    for (unsigned int k = 0; k < M; ++k) {
-      result += values[k];
-    }
-    result /= (double)M;
+  double result = 0.0;
+  for (unsigned int r = m_average_start; r < m_average_end; ++r) {
+    result += m_average_weights[r] * values[r];
   }
   return result;
 }
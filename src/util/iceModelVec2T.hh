@@ -99,6 +99,24 @@ private:
 
   InterpolationType m_interp_type;
   std::shared_ptr<Interpolation> m_interp;
+
+  //! first record, number of records, and requested times used to compute m_interp
+  int m_interp_first;
+  unsigned int m_interp_N;
+  std::vector<double> m_interp_times;
+
+  //! weights used to compute averages over requested times (one per record in memory)
+  std::vector<double> m_average_weights;
+  //! range of records with non-zero weights
+  unsigned int m_average_start, m_average_end;
+
+  //! in-file index of the record copied to the 2D field by interp(double), or -1
+  int m_current_record;
+  //! true if the 2D field contains the average computed using current weights
+  bool m_current_average;
+  //! state counter of the 2D field right after interp(double) or average(double, double)
+  //! modified it (used to detect modifications by other code)
+  int m_current_counter;
   unsigned int m_period;        // in years
   double m_reference_time;      // in seconds
 
@@ -108,6 +126,8 @@ private:
   double average(int i, int j);
   void set_record(int n);
   void get_record(int n);
+  void use_record(unsigned int n);
+  void discard_current();
 };
 
 
@@ -19,6 +19,7 @@
 #include <cassert>
 #include <cstdio>
 #include <memory>
+#include <algorithm>          // std::min, std::max
 using std::shared_ptr;
 
 #include <petscvec.h>
@@ -47,6 +48,7 @@ using std::shared_ptr;
 
 #include "pism/util/error_handling.hh"
 #include "pism/util/io/io_helpers.hh"
+#include "pism/util/io/RawCheckpoint.hh"
 
 namespace pism {
 
@@ -54,6 +56,9 @@ struct File::Impl {
   MPI_Comm com;
   IO_Backend backend;
   io::NCFile::Ptr nc;
+  StorageSettings storage;
+  GridWindow window;
+  std::shared_ptr<RawCheckpoint> raw;
 };
 
 IO_Backend string_to_backend(const std::string &backend) {
@@ -82,6 +87,65 @@ IO_Backend string_to_backend(const std::string &backend) {
                                 "unknown or unsupported I/O backend: %s", backend.c_str());
 }
 
+bool supports_windows(IO_Backend backend) {
+  // Each process writes its part of a window using a separate call. ParallelIO expects
+  // the same data from all tasks in calls writing an arbitrary block of a variable.
+  return not (backend == PISM_PIO_PNETCDF or
+              backend == PISM_PIO_NETCDF or
+              backend == PISM_PIO_NETCDF4C or
+              backend == PISM_PIO_NETCDF4P);
+}
+
+bool supports_quantization(IO_Backend backend) {
+  // NetCDF-3 and PnetCDF formats cannot store filtered variables; ParallelIO does not
+  // provide an interface for quantization.
+  return backend == PISM_NETCDF4_PARALLEL;
+}
+
+StorageSettings::Chunking string_to_chunking(const std::string &chunking) {
+  if (chunking == "map") {
+    return StorageSettings::CHUNK_MAP;
+  }
+  if (chunking == "time_series") {
+    return StorageSettings::CHUNK_TIME_SERIES;
+  }
+  throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                "unknown chunking type: %s", chunking.c_str());
+}
+
+StorageSettings::StorageSettings()
+  : chunking(CHUNK_MAP), compression_level(0), shuffle(false), significant_bits(0) {
+  // empty
+}
+
+//! Lossless storage settings (compression and shuffling) from the configuration database.
+StorageSettings::StorageSettings(const Config &config)
+  : chunking(CHUNK_MAP), significant_bits(0) {
+  compression_level = config.get_number("output.netcdf4.compression_level");
+  shuffle           = config.get_flag("output.netcdf4.shuffle");
+
+  if (compression_level < 0 or compression_level > 9) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "output.netcdf4.compression_level = %d is invalid"
+                                  " (has to be between 0 and 9)", compression_level);
+  }
+}
+
+GridWindow::GridWindow()
+  : x_start(0), x_count(0), y_start(0), y_count(0) {
+  // empty
+}
+
+GridWindow::GridWindow(unsigned int xs, unsigned int xm,
+                       unsigned int ys, unsigned int ym)
+  : x_start(xs), x_count(xm), y_start(ys), y_count(ym) {
+  // empty
+}
+
+bool GridWindow::empty() const {
+  return x_count == 0 or y_count == 0;
+}
+
 // Chooses the best available I/O backend for reading from 'filename'.
 static IO_Backend choose_backend(MPI_Comm com, const std::string &filename) {
 
@@ -187,6 +251,42 @@ IO_Backend File::backend() const {
   return m_impl->backend;
 }
 
+//! Set storage settings used by define_variable() (affects NetCDF-4 files only).
+void File::set_storage_settings(const StorageSettings &settings) {
+  m_impl->storage = settings;
+}
+
+//! Restrict spatial variables written to this file to a rectangular part of the grid.
+/*!
+ * Has to be called before any spatial variables are defined.
+ */
+void File::set_window(const GridWindow &window) {
+  if (not window.empty() and not supports_windows(backend())) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "cannot write a part of the grid to %s:"
+                                  " ParallelIO backends do not support this",
+                                  filename().c_str());
+  }
+  m_impl->window = window;
+}
+
+const GridWindow& File::window() const {
+  return m_impl->window;
+}
+
+//! Use a raw checkpoint to store or read spatial variables (see RawCheckpoint).
+/*!
+ * When writing, this has to be called before any spatial variables are defined.
+ */
+void File::set_raw_checkpoint(std::shared_ptr<RawCheckpoint> checkpoint) {
+  m_impl->raw = checkpoint;
+}
+
+//! Returns the raw checkpoint corresponding to this file or NULL.
+RawCheckpoint* File::raw_checkpoint() const {
+  return m_impl->raw.get();
+}
+
 void File::open(const std::string &filename, IO_Mode mode) {
   try {
 
@@ -233,6 +333,7 @@ void File::remove_attribute(const std::string &variable_name, const std::string
 
 void File::close() {
   try {
+    m_impl->raw.reset();
     m_impl->nc->close();
   } catch (RuntimeError &e) {
     e.add_context("closing \"" + filename() + "\"");
@@ -512,30 +613,118 @@ void File::define_dimension(const std::string &name, size_t length) const {
   }
 }
 
+static size_t type_size(IO_Type nctype) {
+  switch (nctype) {
+  case PISM_BYTE:
+  case PISM_CHAR:
+    return 1;
+  case PISM_SHORT:
+    return 2;
+  case PISM_INT:
+  case PISM_FLOAT:
+    return 4;
+  case PISM_DOUBLE:
+  default:
+    return 8;
+  }
+}
+
+//! Compute chunk dimensions of a variable.
+/*!
+ * Dimensions are assumed to be ordered as in PISM's output files: [time,] y, x [, z or
+ * other]. Trailing dimensions are never split.
+ *
+ * - CHUNK_MAP: a chunk contains one record and (if small enough) the whole map. This
+ *   matches the way PISM writes output, one record at a time.
+ *
+ * - CHUNK_TIME_SERIES: a chunk contains many records and a small patch, making it
+ *   cheap to read a time series at a point (at the cost of slower writing).
+ *
+ * In both cases the patch is halved in x and y until a chunk fits in max_chunk_size.
+ */
+static std::vector<size_t> chunk_dimensions(IO_Type nctype,
+                                            const std::vector<size_t> &dim_lengths,
+                                            bool time_dependent,
+                                            StorageSettings::Chunking chunking) {
+  // 4 MiB is the default size of the NetCDF-4 chunk cache
+  const size_t max_chunk_size = 4 * 1024 * 1024;
+  // number of records per chunk in the "time series" mode
+  const size_t records_per_chunk = 64;
+  // maximum patch size in the "time series" mode
+  const size_t max_patch_size = 32;
+
+  std::vector<size_t> result = dim_lengths;
+
+  const size_t Y = time_dependent ? 1 : 0, X = Y + 1;
+
+  if (time_dependent) {
+    result[0] = chunking == StorageSettings::CHUNK_TIME_SERIES ? records_per_chunk : 1;
+  }
+
+  if (chunking == StorageSettings::CHUNK_TIME_SERIES) {
+    result[X] = std::min(result[X], max_patch_size);
+    result[Y] = std::min(result[Y], max_patch_size);
+  }
+
+  for (auto &n : result) {
+    n = std::max(n, (size_t)1);
+  }
+
+  auto chunk_size = [&]() {
+    size_t size = type_size(nctype);
+    for (auto n : result) {
+      size *= n;
+    }
+    return size;
+  };
+
+  while (chunk_size() > max_chunk_size and (result[X] > 1 or result[Y] > 1)) {
+    size_t &n = result[X] >= result[Y] ? result[X] : result[Y];
+    n = (n + 1) / 2;
+  }
+
+  return result;
+}
+
 //! \brief Define a variable.
+/*!
+ * Uses storage settings (see set_storage_settings()) to set chunking, compression and
+ * quantization of variables with at least two non-time dimensions. These are ignored by
+ * backends that do not support them.
+ */
 void File::define_variable(const std::string &name, IO_Type nctype, const std::vector<std::string> &dims) const {
   try {
     m_impl->nc->def_var(name, nctype, dims);
 
-    // FIXME: I need to write and tune chunk_dimensions that would be called below before we use
-    // this.
-    //
-    /*
+    std::string time_dimension;
+    m_impl->nc->inq_unlimdim(time_dimension);
+
+    bool time_dependent = (not dims.empty() and dims[0] == time_dimension);
+
     // if it's not a spatial variable, we're done
-    if (dims.size() < 2) {
+    if (dims.size() - (time_dependent ? 1 : 0) < 2) {
       return;
     }
 
+    const StorageSettings &storage = m_impl->storage;
+
     std::vector<size_t> dim_lengths;
-    for (unsigned int k = 0; k < dims.size(); ++k) {
-      dim_lengths.push_back(this->dimension_length(dims[k]));
+    for (auto d : dims) {
+      dim_lengths.push_back(this->dimension_length(d));
     }
 
-    std::vector<size_t> chunk_dims = chunk_dimensions(nctype, dim_lengths);
+    std::vector<size_t> chunk_dims = chunk_dimensions(nctype, dim_lengths,
+                                                      time_dependent, storage.chunking);
 
     m_impl->nc->def_var_chunking(name, chunk_dims);
-    */
 
+    if (storage.significant_bits > 0 and (nctype == PISM_FLOAT or nctype == PISM_DOUBLE)) {
+      m_impl->nc->def_var_quantize(name, storage.significant_bits);
+    }
+
+    if (storage.compression_level > 0) {
+      m_impl->nc->def_var_deflate(name, storage.shuffle, storage.compression_level);
+    }
   } catch (RuntimeError &e) {
     e.add_context("defining variable '%s' in '%s'", name.c_str(), filename().c_str());
     throw;
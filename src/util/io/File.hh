@@ -21,6 +21,7 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 #include <mpi.h>
 
 #include "pism/util/Units.hh"
@@ -31,12 +32,67 @@ namespace pism {
 enum AxisType {X_AXIS, Y_AXIS, Z_AXIS, T_AXIS, UNKNOWN_AXIS};
 
 class IceGrid;
+class Config;
+class RawCheckpoint;
 
 /*!
  * Convert a string to PISM's backend type.
  */
 IO_Backend string_to_backend(const std::string &backend);
 
+/*!
+ * Returns true if `backend` supports writing a rectangular window of the grid (see
+ * File::set_window()).
+ */
+bool supports_windows(IO_Backend backend);
+
+/*!
+ * Returns true if `backend` can store quantized variables (see
+ * StorageSettings::significant_bits).
+ */
+bool supports_quantization(IO_Backend backend);
+
+//! Settings used to store variables in NetCDF-4 files (ignored by other formats).
+struct StorageSettings {
+  //! Chunk shapes of spatial variables.
+  enum Chunking {
+    //! one record per chunk: fast writing and reading of maps
+    CHUNK_MAP,
+    //! many records and a small patch per chunk: fast reading of time series at a point
+    CHUNK_TIME_SERIES
+  };
+
+  StorageSettings();
+  StorageSettings(const Config &config);
+
+  Chunking chunking;
+  //! deflate compression level (0 disables compression)
+  int compression_level;
+  //! use the shuffle filter when compressing
+  bool shuffle;
+  //! number of significant bits kept by bit rounding (0 disables quantization)
+  int significant_bits;
+};
+
+/*!
+ * Convert a string ("map" or "time_series") to a chunking type.
+ */
+StorageSettings::Chunking string_to_chunking(const std::string &chunking);
+
+//! Rectangular subset of a grid (in terms of grid indexes) written to a file.
+/*!
+ * An empty window (the default) corresponds to the whole grid.
+ */
+struct GridWindow {
+  GridWindow();
+  GridWindow(unsigned int x_start, unsigned int x_count,
+             unsigned int y_start, unsigned int y_count);
+
+  bool empty() const;
+
+  unsigned int x_start, x_count, y_start, y_count;
+};
+
 struct VariableLookupData {
   bool exists;
   bool found_using_standard_name;
@@ -56,6 +112,14 @@ public:
 
   IO_Backend backend() const;
 
+  void set_storage_settings(const StorageSettings &settings);
+
+  void set_window(const GridWindow &window);
+  const GridWindow& window() const;
+
+  void set_raw_checkpoint(std::shared_ptr<RawCheckpoint> checkpoint);
+  RawCheckpoint* raw_checkpoint() const;
+
   MPI_Comm com() const;
 
   void close();
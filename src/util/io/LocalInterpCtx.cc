@@ -19,6 +19,7 @@
 #include <cstring>
 #include <cstdlib>
 #include <algorithm>            // std::min
+#include <list>
 #include <gsl/gsl_interp.h>
 
 #include "File.hh"
@@ -108,25 +109,6 @@ LocalInterpCtx::LocalInterpCtx(const grid_info &input, const IceGrid &grid,
   start[Z] = 0;                    // always start at the base
   count[Z] = std::max(input.z_len, 1u); // read at least one level
 
-  // We need a buffer for the local data, but node 0 needs to have as much
-  // storage as the node with the largest block (which may be anywhere), hence
-  // we perform a reduce so that node 0 has the maximum value.
-  unsigned int buffer_size = count[X] * count[Y] * std::max(count[Z], 1u);
-  unsigned int proc0_buffer_size = buffer_size;
-  MPI_Reduce(&buffer_size, &proc0_buffer_size, 1, MPI_UNSIGNED, MPI_MAX, 0, grid.com);
-
-  ParallelSection allocation(grid.com);
-  try {
-    if (grid.rank() == 0) {
-      buffer.resize(proc0_buffer_size);
-    } else {
-      buffer.resize(buffer_size);
-    }
-  } catch (...) {
-    allocation.failed();
-  }
-  allocation.check();
-
   if (type == LINEAR or type == NEAREST) {
     x.reset(new Interpolation(type, &input.x[start[X]], count[X],
                               &grid.x()[grid.xs()], grid.xm()));
@@ -140,4 +122,87 @@ LocalInterpCtx::LocalInterpCtx(const grid_info &input, const IceGrid &grid,
   }
 }
 
+unsigned int LocalInterpCtx::buffer_size() const {
+  const int X = 1, Y = 2, Z = 3; // indices, just for clarity
+
+  return count[X] * count[Y] * std::max(count[Z], 1u);
+}
+
+namespace {
+
+//! A cached local interpolation context and the data it was computed from.
+struct CacheEntry {
+  unsigned int t_len;
+  std::vector<double> input_x, input_y, input_z, output_x, output_y, output_z;
+  InterpolationType type;
+
+  LocalInterpCtx::ConstPtr context;
+};
+
+//! Recently used interpolation contexts (most recently used first).
+std::list<CacheEntry> interpolation_cache;
+
+//! Maximum number of cached interpolation contexts.
+const size_t max_cache_size = 8;
+
+} // end of anonymous namespace
+
+//! Get a local interpolation context, re-using a cached one if possible.
+/*!
+ * Regridding many variables (during bootstrapping or when using `-regrid_file`) usually
+ * involves few distinct combinations of input and output grids. Caching contexts avoids
+ * re-computing the same indexes and weights for every variable.
+ *
+ * The cache is local to each process: a context depends on the processor's part of the
+ * output grid only and creating it does not involve communication.
+ */
+LocalInterpCtx::ConstPtr LocalInterpCtx::get(const grid_info &input, const IceGrid &grid,
+                                             const std::vector<double> &z_output,
+                                             InterpolationType type) {
+  const auto
+    x_begin = grid.x().begin() + grid.xs(),
+    y_begin = grid.y().begin() + grid.ys();
+
+  std::vector<double>
+    output_x(x_begin, x_begin + grid.xm()),
+    output_y(y_begin, y_begin + grid.ym());
+
+  for (auto e = interpolation_cache.begin(); e != interpolation_cache.end(); ++e) {
+    if (e->type == type and
+        e->t_len == input.t_len and
+        e->input_x == input.x and
+        e->input_y == input.y and
+        e->input_z == input.z and
+        e->output_x == output_x and
+        e->output_y == output_y and
+        e->output_z == z_output) {
+      // move to the front
+      interpolation_cache.splice(interpolation_cache.begin(), interpolation_cache, e);
+
+      grid.ctx()->log()->message(4, "\nRe-using a regridding context\n");
+
+      return e->context;
+    }
+  }
+
+  CacheEntry entry;
+  entry.t_len    = input.t_len;
+  entry.input_x  = input.x;
+  entry.input_y  = input.y;
+  entry.input_z  = input.z;
+  entry.output_x = output_x;
+  entry.output_y = output_y;
+  entry.output_z = z_output;
+  entry.type     = type;
+  entry.context  = ConstPtr(new LocalInterpCtx(input, grid, z_output, type));
+
+  interpolation_cache.push_front(entry);
+
+  if (interpolation_cache.size() > max_cache_size) {
+    interpolation_cache.pop_back();
+  }
+
+  return entry.context;
+}
+
 } // end of namespace pism
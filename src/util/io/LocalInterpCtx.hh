@@ -46,17 +46,28 @@ class grid_info;
 
   The arrays `start` and `count` have 4 integer entries, corresponding to the dimensions
   \f$t, x, y, z(zb)\f$.
+
+  A context depends on the input grid, the processor's part of the output grid and the
+  output vertical grid only, so it can be re-used to regrid all variables sharing these.
+  Use LocalInterpCtx::get() to get a (possibly cached) context.
 */
 class LocalInterpCtx {
 public:
+  typedef std::shared_ptr<const LocalInterpCtx> ConstPtr;
+
   LocalInterpCtx(const grid_info &input, const IceGrid &grid,
                  const std::vector<double> &z_output, InterpolationType type);
+
+  static ConstPtr get(const grid_info &input, const IceGrid &grid,
+                      const std::vector<double> &z_output, InterpolationType type);
+
+  //! Size of the buffer needed to store the processor's part of the input.
+  unsigned int buffer_size() const;
+
   // Indices in netCDF file.
   unsigned int start[4], count[4];
   // indexes and coefficients for 1D linear interpolation
   std::shared_ptr<Interpolation> x, y, z;
-  //! temporary storage
-  std::vector<double> buffer;
 };
 
 } // end of namespace pism
@@ -50,6 +50,79 @@ static void check_and_abort(MPI_Comm com, const ErrorLocation &where, int return
   }
 }
 
+//! Maximum number of values in the buffer processor 0 uses to read and write data.
+/*!
+ * The buffer is larger if a patch of one process is larger than this.
+ */
+static const size_t max_buffer_size = 8 * 1024 * 1024; // 64 MiB
+
+//! Gather sizes of patches of all processes (on all processes) and their starts and counts
+//! (on processor 0).
+static void gather_patches(MPI_Comm com,
+                           const std::vector<unsigned int> &start,
+                           const std::vector<unsigned int> &count,
+                           std::vector<int> &chunk_size,
+                           std::vector<unsigned int> &all_start,
+                           std::vector<unsigned int> &all_count) {
+  int rank = 0, com_size = 0, ndims = static_cast<int>(start.size());
+  MPI_Comm_rank(com, &rank);
+  MPI_Comm_size(com, &com_size);
+
+  int local_chunk_size = 1;
+  for (int k = 0; k < ndims; ++k) {
+    local_chunk_size *= count[k];
+  }
+
+  chunk_size.resize(com_size);
+  MPI_Allgather(&local_chunk_size, 1, MPI_INT, chunk_size.data(), 1, MPI_INT, com);
+
+  all_start.resize(rank == 0 ? ndims * com_size : 0);
+  all_count.resize(rank == 0 ? ndims * com_size : 0);
+
+  MPI_Gather(const_cast<unsigned int*>(start.data()), ndims, MPI_UNSIGNED,
+             all_start.data(), ndims, MPI_UNSIGNED, 0, com);
+  MPI_Gather(const_cast<unsigned int*>(count.data()), ndims, MPI_UNSIGNED,
+             all_count.data(), ndims, MPI_UNSIGNED, 0, com);
+}
+
+//! Split processes into groups of consecutive ranks so that the total size of patches in
+//! a group does not exceed `max_size` (unless a group contains one process).
+/*!
+ * Returns the first rank of each group, followed by the size of the communicator.
+ */
+static std::vector<int> rank_groups(const std::vector<int> &chunk_size, size_t max_size) {
+  std::vector<int> result = {0};
+
+  size_t total = 0;
+  for (int r = 0; r < (int)chunk_size.size(); ++r) {
+    if (total > 0 and total + chunk_size[r] > max_size) {
+      result.push_back(r);
+      total = 0;
+    }
+    total += chunk_size[r];
+  }
+  result.push_back(chunk_size.size());
+
+  return result;
+}
+
+//! Compute counts and displacements for MPI_Gatherv() and MPI_Scatterv() involving
+//! processes in `[first, last)`. Returns the total size.
+static size_t group_layout(const std::vector<int> &chunk_size, int first, int last,
+                           std::vector<int> &counts, std::vector<int> &displacements) {
+  counts.assign(chunk_size.size(), 0);
+  displacements.assign(chunk_size.size(), 0);
+
+  int total = 0;
+  for (int r = first; r < last; ++r) {
+    counts[r]        = chunk_size[r];
+    displacements[r] = total;
+    total += chunk_size[r];
+  }
+
+  return total;
+}
+
 NC3File::NC3File(MPI_Comm c)
   : NCFile(c), m_rank(0) {
   MPI_Comm_rank(m_com, &m_rank);
@@ -290,187 +363,137 @@ void NC3File::get_vara_double_impl(const std::string &variable_name,
 }
 
 //! \brief Get variable data.
+/*!
+ * Processor 0 reads patches of all processes and distributes them using MPI_Scatterv().
+ * Processes are split into groups of consecutive ranks (see rank_groups()) to limit the
+ * size of the buffer on processor 0.
+ */
 void NC3File::get_var_double(const std::string &variable_name,
                             const std::vector<unsigned int> &start_input,
                             const std::vector<unsigned int> &count_input,
                             const std::vector<unsigned int> &imap_input, double *ip,
                             bool transposed) const {
-  std::vector<unsigned int> start = start_input;
-  std::vector<unsigned int> count = count_input;
   std::vector<unsigned int> imap = imap_input;
-  const int start_tag = 1,
-    count_tag = 2,
-    data_tag =  3,
-    imap_tag =  4,
-    chunk_size_tag = 5;
-  int stat = NC_NOERR, com_size, ndims = static_cast<int>(start.size());
-  std::vector<double> processor_0_buffer;
-  MPI_Status mpi_stat;
-  unsigned int local_chunk_size = 1,
-    processor_0_chunk_size = 0;
+  int stat = NC_NOERR, com_size = 0, ndims = static_cast<int>(start_input.size());
 
   if (not transposed) {
     imap.resize(ndims);
   }
 
-  // get the size of the communicator
   MPI_Comm_size(m_com, &com_size);
 
-  // compute the size of a local chunk
-  for (int k = 0; k < ndims; ++k) {
-    local_chunk_size *= count[k];
-  }
+  std::vector<int> chunk_size;
+  std::vector<unsigned int> start, count;
+  gather_patches(m_com, start_input, count_input, chunk_size, start, count);
 
-  // compute the maximum and send it to processor 0; this is the size of the
-  // buffer processor 0 will need
-  MPI_Reduce(&local_chunk_size, &processor_0_chunk_size, 1, MPI_UNSIGNED, MPI_MAX, 0, m_com);
+  std::vector<unsigned int> all_imap(m_rank == 0 ? ndims * com_size : 0);
+  MPI_Gather(imap.data(), ndims, MPI_UNSIGNED, all_imap.data(), ndims, MPI_UNSIGNED, 0, m_com);
 
-  // now we need to send start, count and imap data to processor 0 and receive data
+  int varid = 0;
   if (m_rank == 0) {
-    // Note: this could be optimized: if processor_0_chunk_size <=
-    // max(local_chunk_size) we can avoid allocating this buffer. The inner for
-    // loop will have to be re-ordered, though.
-    processor_0_buffer.resize(processor_0_chunk_size);
-
-    // MPI calls below require C datatypes (so that we don't have to worry
-    // about sizes of size_t and ptrdiff_t), so we make local copies of start,
-    // count, and imap to use in the nc_get_varm_double() call.
-    std::vector<size_t> nc_start(ndims), nc_count(ndims);
-    std::vector<ptrdiff_t> nc_imap(ndims), nc_stride(ndims);
-    int varid;
-
     stat = nc_inq_varid(m_file_id, variable_name.c_str(), &varid);
     check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
+  }
 
-    for (int r = 0; r < com_size; ++r) {
+  std::vector<double> processor_0_buffer;
+  std::vector<int> counts, displacements;
 
-      if (r != 0) {
-        // Note: start, count, imap, and local_chunk_size on processor zero are
-        // used *before* they get overwritten by these calls
-        MPI_Recv(&start[0],         ndims, MPI_UNSIGNED, r, start_tag,      m_com, &mpi_stat);
-        MPI_Recv(&count[0],         ndims, MPI_UNSIGNED, r, count_tag,      m_com, &mpi_stat);
-        MPI_Recv(&imap[0],          ndims, MPI_UNSIGNED, r, imap_tag,       m_com, &mpi_stat);
-        MPI_Recv(&local_chunk_size, 1,     MPI_UNSIGNED, r, chunk_size_tag, m_com, &mpi_stat);
-      }
+  std::vector<int> groups = rank_groups(chunk_size, max_buffer_size);
+  for (unsigned int g = 0; g < groups.size() - 1; ++g) {
+    size_t buffer_size = group_layout(chunk_size, groups[g], groups[g + 1],
+                                      counts, displacements);
 
-      // This for loop uses start, count and imap passed in as arguments when r
-      // == 0. For r > 0 they are overwritten by MPI_Recv calls above.
-      for (int k = 0; k < ndims; ++k) {
-        nc_start[k]  = start[k];
-        nc_count[k]  = count[k];
-        nc_imap[k]   = imap[k];
-        nc_stride[k] = 1;       // fill with ones; this way it works even with
-                                // NetCDF versions with a bug affecting the
-                                // stride == NULL case.
-      }
+    if (m_rank == 0) {
+      processor_0_buffer.resize(buffer_size);
+
+      // MPI calls above use C datatypes (so that we don't have to worry about sizes of
+      // size_t and ptrdiff_t), so we make local copies of start, count, and imap to use
+      // in the nc_get_varm_double() call.
+      std::vector<size_t> nc_start(ndims), nc_count(ndims);
+      std::vector<ptrdiff_t> nc_imap(ndims), nc_stride(ndims);
+
+      for (int r = groups[g]; r < groups[g + 1]; ++r) {
+        for (int k = 0; k < ndims; ++k) {
+          nc_start[k]  = start[r * ndims + k];
+          nc_count[k]  = count[r * ndims + k];
+          nc_imap[k]   = all_imap[r * ndims + k];
+          nc_stride[k] = 1;       // fill with ones; this way it works even with
+                                  // NetCDF versions with a bug affecting the
+                                  // stride == NULL case.
+        }
 
-      if (transposed) {
-        stat = nc_get_varm_double(m_file_id, varid, &nc_start[0], &nc_count[0], &nc_stride[0], &nc_imap[0],
-                                  &processor_0_buffer[0]);
-      } else {
-        stat = nc_get_vara_double(m_file_id, varid, &nc_start[0], &nc_count[0],
-                                  &processor_0_buffer[0]);
-      }
-      check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
+        double *data = processor_0_buffer.data() + displacements[r];
 
-      if (r != 0) {
-        MPI_Send(&processor_0_buffer[0], local_chunk_size, MPI_DOUBLE, r, data_tag, m_com);
-      } else {
-        for (unsigned int k = 0; k < local_chunk_size; ++k) {
-          ip[k] = processor_0_buffer[k];
+        if (transposed) {
+          stat = nc_get_varm_double(m_file_id, varid, &nc_start[0], &nc_count[0],
+                                    &nc_stride[0], &nc_imap[0], data);
+        } else {
+          stat = nc_get_vara_double(m_file_id, varid, &nc_start[0], &nc_count[0], data);
         }
+        check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
       }
-    } // end of the for loop
-
-  } else {
-    MPI_Send(&start[0],          ndims, MPI_UNSIGNED, 0, start_tag,      m_com);
-    MPI_Send(&count[0],          ndims, MPI_UNSIGNED, 0, count_tag,      m_com);
-    MPI_Send(&imap[0],           ndims, MPI_UNSIGNED, 0, imap_tag,       m_com);
-    MPI_Send(&local_chunk_size,  1,     MPI_UNSIGNED, 0, chunk_size_tag, m_com);
+    }
 
-    MPI_Recv(ip, local_chunk_size, MPI_DOUBLE, 0, data_tag, m_com, &mpi_stat);
+    MPI_Scatterv(processor_0_buffer.data(), counts.data(), displacements.data(), MPI_DOUBLE,
+                 ip, counts[m_rank], MPI_DOUBLE, 0, m_com);
   }
 }
 
+//! \brief Write variable data.
+/*!
+ * Processor 0 collects patches of all processes using MPI_Gatherv() and writes them.
+ * Processes are split into groups of consecutive ranks (see rank_groups()) to limit the
+ * size of the buffer on processor 0.
+ */
 void NC3File::put_vara_double_impl(const std::string &variable_name,
                                  const std::vector<unsigned int> &start_input,
                                  const std::vector<unsigned int> &count_input,
                                  const double *op) const {
-  // make copies of start and count so that we can use them in MPI_Recv() calls below
-  std::vector<unsigned int> start = start_input;
-  std::vector<unsigned int> count = count_input;
-  const int start_tag = 1,
-    count_tag = 2,
-    data_tag =  3,
-    chunk_size_tag = 4;
-  int stat = NC_NOERR, com_size = 0, ndims = static_cast<int>(start.size());
-  std::vector<double> processor_0_buffer;
-  MPI_Status mpi_stat;
-  unsigned int local_chunk_size = 1,
-    processor_0_chunk_size = 0;
-
-  // get the size of the communicator
-  MPI_Comm_size(m_com, &com_size);
-
-  // compute the size of a local chunk
-  for (int k = 0; k < ndims; ++k) {
-    local_chunk_size *= count[k];
-  }
+  int stat = NC_NOERR, ndims = static_cast<int>(start_input.size());
 
-  // compute the maximum and send it to processor 0; this is the size of the
-  // buffer processor 0 will need
-  MPI_Reduce(&local_chunk_size, &processor_0_chunk_size, 1, MPI_UNSIGNED, MPI_MAX, 0, m_com);
+  std::vector<int> chunk_size;
+  std::vector<unsigned int> start, count;
+  gather_patches(m_com, start_input, count_input, chunk_size, start, count);
 
-  // now we need to send start and count data to processor 0 and receive data
+  int varid = 0;
   if (m_rank == 0) {
-    processor_0_buffer.resize(processor_0_chunk_size);
-
-    // MPI calls below require C datatypes (so that we don't have to worry about sizes of
-    // size_t and ptrdiff_t), so we make local copies of start and count to use in the
-    // nc_get_vara_double() call.
-    std::vector<size_t> nc_start(ndims), nc_count(ndims);
-    std::vector<ptrdiff_t> nc_stride(ndims);
-    int varid;
-
     stat = nc_inq_varid(m_file_id, variable_name.c_str(), &varid);
     check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
+  }
 
-    for (int r = 0; r < com_size; ++r) {
+  std::vector<double> processor_0_buffer;
+  std::vector<int> counts, displacements;
 
-      if (r != 0) {
-        // Note: start, count, and local_chunk_size on processor zero are used *before*
-        // they get overwritten by these calls
-        MPI_Recv(&start[0],         ndims, MPI_UNSIGNED, r, start_tag,      m_com, &mpi_stat);
-        MPI_Recv(&count[0],         ndims, MPI_UNSIGNED, r, count_tag,      m_com, &mpi_stat);
-        MPI_Recv(&local_chunk_size, 1,     MPI_UNSIGNED, r, chunk_size_tag, m_com, &mpi_stat);
+  std::vector<int> groups = rank_groups(chunk_size, max_buffer_size);
+  for (unsigned int g = 0; g < groups.size() - 1; ++g) {
+    size_t buffer_size = group_layout(chunk_size, groups[g], groups[g + 1],
+                                      counts, displacements);
 
-        MPI_Recv(&processor_0_buffer[0], local_chunk_size, MPI_DOUBLE, r, data_tag, m_com, &mpi_stat);
-      } else {
-        for (unsigned int k = 0; k < local_chunk_size; ++k) {
-          processor_0_buffer[k] = op[k];
-        }
-      }
+    if (m_rank == 0) {
+      processor_0_buffer.resize(buffer_size);
+    }
 
-      // This for loop uses start and count passed in as arguments when r == 0. For r > 0
-      // they are overwritten by MPI_Recv calls above.
-      for (int k = 0; k < ndims; ++k) {
-        nc_start[k]  = start[k];
-        nc_count[k]  = count[k];
-        nc_stride[k] = 1;       // fill with ones; this way it works even with
-                                // NetCDF versions with a bug affecting the
-                                // stride == NULL case.
-      }
+    MPI_Gatherv(const_cast<double*>(op), counts[m_rank], MPI_DOUBLE,
+                processor_0_buffer.data(), counts.data(), displacements.data(), MPI_DOUBLE,
+                0, m_com);
 
-      stat = nc_put_vara_double(m_file_id, varid, &nc_start[0], &nc_count[0],
-                                &processor_0_buffer[0]);
-      check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
-    } // end of the for loop
-  } else {
-    MPI_Send(&start[0],          ndims, MPI_UNSIGNED, 0, start_tag,      m_com);
-    MPI_Send(&count[0],          ndims, MPI_UNSIGNED, 0, count_tag,      m_com);
-    MPI_Send(&local_chunk_size,  1,     MPI_UNSIGNED, 0, chunk_size_tag, m_com);
+    if (m_rank == 0) {
+      // MPI calls above use C datatypes (so that we don't have to worry about sizes of
+      // size_t and ptrdiff_t), so we make local copies of start and count to use in the
+      // nc_put_vara_double() call.
+      std::vector<size_t> nc_start(ndims), nc_count(ndims);
+
+      for (int r = groups[g]; r < groups[g + 1]; ++r) {
+        for (int k = 0; k < ndims; ++k) {
+          nc_start[k] = start[r * ndims + k];
+          nc_count[k] = count[r * ndims + k];
+        }
 
-    MPI_Send(const_cast<double*>(op), local_chunk_size, MPI_DOUBLE, 0, data_tag, m_com);
+        stat = nc_put_vara_double(m_file_id, varid, &nc_start[0], &nc_count[0],
+                                  processor_0_buffer.data() + displacements[r]);
+        check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
+      }
+    }
   }
 }
 
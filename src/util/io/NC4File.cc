@@ -156,6 +156,33 @@ void NC4File::def_var_chunking_impl(const std::string &name,
   check(PISM_ERROR_LOCATION, stat);
 }
 
+void NC4File::def_var_deflate_impl(const std::string &name, bool shuffle, int level) const {
+  int stat = 0, varid = 0;
+
+  stat = nc_inq_varid(m_file_id, name.c_str(), &varid);
+  check(PISM_ERROR_LOCATION, stat);
+
+  stat = nc_def_var_deflate(m_file_id, varid, shuffle ? 1 : 0, 1, level);
+  check(PISM_ERROR_LOCATION, stat);
+}
+
+void NC4File::def_var_quantize_impl(const std::string &name, int significant_bits) const {
+#ifdef NC_QUANTIZE_BITROUND
+  int stat = 0, varid = 0;
+
+  stat = nc_inq_varid(m_file_id, name.c_str(), &varid);
+  check(PISM_ERROR_LOCATION, stat);
+
+  stat = nc_def_var_quantize(m_file_id, varid, NC_QUANTIZE_BITROUND, significant_bits);
+  check(PISM_ERROR_LOCATION, stat);
+#else
+  (void) name;
+  (void) significant_bits;
+  throw RuntimeError(PISM_ERROR_LOCATION,
+                     "quantization requires NetCDF 4.9.0 or newer");
+#endif
+}
+
 void NC4File::get_varm_double_impl(const std::string &variable_name,
                                   const std::vector<unsigned int> &start,
                                   const std::vector<unsigned int> &count,
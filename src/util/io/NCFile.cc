@@ -52,6 +52,19 @@ void NCFile::def_var_chunking_impl(const std::string &name,
   // the default implementation does nothing
 }
 
+void NCFile::def_var_deflate_impl(const std::string &name, bool shuffle, int level) const {
+  (void) name;
+  (void) shuffle;
+  (void) level;
+  // the default implementation does nothing
+}
+
+void NCFile::def_var_quantize_impl(const std::string &name, int significant_bits) const {
+  (void) name;
+  (void) significant_bits;
+  // the default implementation does nothing
+}
+
 
 void NCFile::open(const std::string &filename, IO_Mode mode) {
   this->open_impl(filename, mode);
@@ -118,6 +131,14 @@ void NCFile::def_var_chunking(const std::string &name,
   this->def_var_chunking_impl(name, dimensions);
 }
 
+void NCFile::def_var_deflate(const std::string &name, bool shuffle, int level) const {
+  this->def_var_deflate_impl(name, shuffle, level);
+}
+
+void NCFile::def_var_quantize(const std::string &name, int significant_bits) const {
+  this->def_var_quantize_impl(name, significant_bits);
+}
+
 
 void NCFile::get_vara_double(const std::string &variable_name,
                             const std::vector<unsigned int> &start,
@@ -90,6 +90,10 @@ public:
 
   void def_var_chunking(const std::string &name, std::vector<size_t> &dimensions) const;
 
+  void def_var_deflate(const std::string &name, bool shuffle, int level) const;
+
+  void def_var_quantize(const std::string &name, int significant_bits) const;
+
   void get_vara_double(const std::string &variable_name,
                        const std::vector<unsigned int> &start,
                        const std::vector<unsigned int> &count,
@@ -176,6 +180,10 @@ protected:
   virtual void def_var_chunking_impl(const std::string &name,
                                     std::vector<size_t> &dimensions) const;
 
+  virtual void def_var_deflate_impl(const std::string &name, bool shuffle, int level) const;
+
+  virtual void def_var_quantize_impl(const std::string &name, int significant_bits) const;
+
   virtual void get_vara_double_impl(const std::string &variable_name,
                                    const std::vector<unsigned int> &start,
                                    const std::vector<unsigned int> &count,
@@ -0,0 +1,272 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cstdint>
+#include <ctime>
+#include <vector>
+#include <algorithm>            // std::copy
+
+#include "pism/util/io/RawCheckpoint.hh"
+#include "pism/util/io/File.hh"
+#include "pism/util/io/io_helpers.hh"
+#include "pism/util/IceGrid.hh"
+#include "pism/util/VariableMetadata.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/pism_utilities.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/Logger.hh"
+
+namespace pism {
+
+//! Size of the header of a raw file (in bytes); data start right after it.
+static const int header_size = 1024;
+
+//! Name of the global attribute identifying the raw file corresponding to a NetCDF file.
+static const char *id_attribute = "pism_raw_checkpoint";
+
+static std::string raw_filename(const File &file) {
+  return file.filename() + ".raw";
+}
+
+static std::string header_text(const std::string &id) {
+  return "PISM raw checkpoint\n" + id + "\n";
+}
+
+RawCheckpoint::RawCheckpoint(const IceGrid &grid, const std::string &filename, int mode)
+  : m_com(grid.com), m_file(MPI_FILE_NULL), m_end(header_size) {
+
+  m_local_size = grid.xm() * grid.ym();
+  m_field_size = (MPI_Offset)grid.Mx() * grid.My();
+
+  // sub-domains are stored in the order of MPI ranks
+  MPI_Offset local_size = m_local_size;
+  m_local_offset = 0;
+  MPI_Exscan(&local_size, &m_local_offset, 1, MPI_OFFSET, MPI_SUM, m_com);
+  if (grid.rank() == 0) {
+    // MPI_Exscan leaves the result on rank 0 undefined
+    m_local_offset = 0;
+  }
+
+  int err = MPI_File_open(m_com, filename.c_str(), mode, MPI_INFO_NULL, &m_file);
+  PISM_C_CHK(err, MPI_SUCCESS, "MPI_File_open");
+}
+
+RawCheckpoint::~RawCheckpoint() {
+  if (m_file != MPI_FILE_NULL) {
+    MPI_File_close(&m_file);
+  }
+}
+
+//! Describe the grid and its domain decomposition.
+/*!
+ * Raw data can be read only if this string is the same as the one recorded when they were
+ * written.
+ */
+std::string RawCheckpoint::decomposition(const IceGrid &grid) {
+  int patch[4] = {grid.xs(), grid.xm(), grid.ys(), grid.ym()};
+
+  std::vector<int> patches(4 * grid.size());
+  MPI_Allgather(patch, 4, MPI_INT, patches.data(), 4, MPI_INT, grid.com);
+
+  // FNV-1a hash of all the sub-domains
+  uint64_t hash = 14695981039346656037ULL;
+  for (auto p : patches) {
+    hash ^= static_cast<uint32_t>(p);
+    hash *= 1099511628211ULL;
+  }
+
+  uint16_t one = 1;
+  const char *byte_order = *reinterpret_cast<char*>(&one) == 1 ? "little" : "big";
+
+  return pism::printf("Mx=%u My=%u Mz=%u processes=%u sub-domains=%016llx byte_order=%s",
+                      grid.Mx(), grid.My(), grid.Mz(), grid.size(),
+                      static_cast<unsigned long long>(hash), byte_order);
+}
+
+//! Create the raw file corresponding to `file` (open for writing), discarding its contents.
+/*!
+ * Has to be called before any spatial variables are defined in `file`.
+ */
+RawCheckpoint::Ptr RawCheckpoint::create(const File &file, const IceGrid &grid) {
+  Ptr result(new RawCheckpoint(grid, raw_filename(file), MPI_MODE_CREATE | MPI_MODE_WRONLY));
+
+  int err = MPI_File_set_size(result->m_file, 0);
+  PISM_C_CHK(err, MPI_SUCCESS, "MPI_File_set_size");
+
+  // the creation time makes it possible to detect a raw file that does not belong to
+  // this NetCDF file
+  long int stamp = time(NULL);
+  MPI_Bcast(&stamp, 1, MPI_LONG, 0, grid.com);
+
+  std::string id = pism::printf("%s created=%ld", decomposition(grid).c_str(), stamp);
+
+  std::string text = header_text(id);
+  if (text.size() > (size_t)header_size) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "raw checkpoint header is too long (%d bytes)",
+                                  (int)text.size());
+  }
+
+  ParallelSection loop(grid.com);
+  try {
+    if (grid.rank() == 0) {
+      std::vector<char> header(header_size, '\0');
+      std::copy(text.begin(), text.end(), header.begin());
+
+      err = MPI_File_write_at(result->m_file, 0, header.data(), header_size, MPI_CHAR,
+                              MPI_STATUS_IGNORE);
+      PISM_C_CHK(err, MPI_SUCCESS, "MPI_File_write_at");
+    }
+  } catch (...) {
+    loop.failed();
+  }
+  loop.check();
+
+  file.write_attribute("PISM_GLOBAL", id_attribute, id);
+
+  return result;
+}
+
+//! Open the raw file corresponding to `file`.
+/*!
+ * Returns an empty pointer if `file` does not have a raw checkpoint or if it cannot be
+ * used with `grid`.
+ */
+RawCheckpoint::Ptr RawCheckpoint::open(const File &file, const IceGrid &grid) {
+  const Logger &log = *grid.ctx()->log();
+
+  if (file.attribute_type("PISM_GLOBAL", id_attribute) != PISM_CHAR) {
+    return Ptr();
+  }
+
+  std::string
+    filename = raw_filename(file),
+    id       = file.read_text_attribute("PISM_GLOBAL", id_attribute);
+
+  if (id.find(decomposition(grid) + " ") != 0) {
+    log.message(2,
+                "  Raw checkpoint '%s' uses a different grid or domain decomposition.\n"
+                "  Reading '%s' instead.\n",
+                filename.c_str(), file.filename().c_str());
+    return Ptr();
+  }
+
+  if (not io::file_exists(grid.com, filename)) {
+    log.message(2, "  Raw checkpoint '%s' is missing. Reading '%s' instead.\n",
+                filename.c_str(), file.filename().c_str());
+    return Ptr();
+  }
+
+  Ptr result(new RawCheckpoint(grid, filename, MPI_MODE_RDONLY));
+
+  std::vector<char> header(header_size, '\0');
+  int err = MPI_File_read_at_all(result->m_file, 0, header.data(), header_size, MPI_CHAR,
+                                 MPI_STATUS_IGNORE);
+  PISM_C_CHK(err, MPI_SUCCESS, "MPI_File_read_at_all");
+
+  std::string text = header_text(id);
+  if (text.size() > header.size() or
+      not std::equal(text.begin(), text.end(), header.begin())) {
+    log.message(2,
+                "  Raw checkpoint '%s' does not match '%s'.\n"
+                "  Reading '%s' instead.\n",
+                filename.c_str(), file.filename().c_str(), file.filename().c_str());
+    return Ptr();
+  }
+
+  log.message(2, "  Reading model state from the raw checkpoint '%s'...\n", filename.c_str());
+
+  return result;
+}
+
+//! Allocate space for a variable and record its location in `file` (in define mode).
+void RawCheckpoint::define(const File &file, const SpatialVariableMetadata &variable,
+                           unsigned int nlevels) {
+  const std::string &name = variable.get_name();
+
+  file.write_attribute(name, "pism_raw_offset", PISM_DOUBLE, {(double)m_end});
+  file.write_attribute(name, "pism_raw_levels", PISM_INT, {(double)nlevels});
+
+  m_end += m_field_size * nlevels * sizeof(double);
+}
+
+//! Write a distributed array (in internal units, without ghosts).
+void RawCheckpoint::write(const File &file, const SpatialVariableMetadata &variable,
+                          unsigned int nlevels, const double *input) const {
+  const std::string &name = variable.get_name();
+
+  if (file.attribute_type(name, "pism_raw_offset") == PISM_NAT) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "variable '%s' in '%s' is not in the raw checkpoint",
+                                  name.c_str(), file.filename().c_str());
+  }
+
+  MPI_Offset start = (MPI_Offset)file.read_double_attribute(name, "pism_raw_offset")[0];
+  start += m_local_offset * nlevels * sizeof(double);
+
+  int err = MPI_File_write_at_all(m_file, start, const_cast<double*>(input),
+                                  m_local_size * nlevels, MPI_DOUBLE, MPI_STATUS_IGNORE);
+  PISM_C_CHK(err, MPI_SUCCESS, "MPI_File_write_at_all");
+}
+
+//! Read a distributed array (in internal units, without ghosts).
+/*!
+ * Returns false if the raw checkpoint does not contain this variable (or this record). The
+ * result is the same on all processes.
+ */
+bool RawCheckpoint::read(const File &file, const SpatialVariableMetadata &variable,
+                         unsigned int time, unsigned int nlevels, double *output) const {
+  const std::string &name = variable.get_name();
+
+  if (not file.find_variable(name) or
+      file.attribute_type(name, "pism_raw_offset") == PISM_NAT or
+      file.attribute_type(name, "pism_raw_levels") == PISM_NAT) {
+    return false;
+  }
+
+  // only the last record is stored
+  if (not variable.get_time_independent() and time + 1 != file.nrecords()) {
+    return false;
+  }
+
+  auto levels = file.read_double_attribute(name, "pism_raw_levels");
+  if (levels.size() != 1 or (unsigned int)levels[0] != nlevels) {
+    return false;
+  }
+
+  MPI_Offset start = (MPI_Offset)file.read_double_attribute(name, "pism_raw_offset")[0];
+  start += m_local_offset * nlevels * sizeof(double);
+
+  const int size = m_local_size * nlevels;
+
+  MPI_Status status;
+  int err = MPI_File_read_at_all(m_file, start, output, size, MPI_DOUBLE, &status);
+  PISM_C_CHK(err, MPI_SUCCESS, "MPI_File_read_at_all");
+
+  // a truncated raw file is not an error: the caller can read the NetCDF file instead
+  int count = 0;
+  MPI_Get_count(&status, MPI_DOUBLE, &count);
+
+  int success = count == size, global_success = 0;
+  MPI_Allreduce(&success, &global_success, 1, MPI_INT, MPI_LAND, m_com);
+
+  return global_success == 1;
+}
+
+} // end of namespace pism
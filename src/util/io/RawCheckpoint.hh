@@ -0,0 +1,88 @@
+/* Copyright (C) 2020 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_RAWCHECKPOINT_H
+#define PISM_RAWCHECKPOINT_H
+
+#include <memory>
+#include <string>
+#include <mpi.h>
+
+namespace pism {
+
+class File;
+class IceGrid;
+class SpatialVariableMetadata;
+
+//! Raw copy of spatial variables stored next to a NetCDF file.
+/*!
+ * The file `foo.nc.raw` next to `foo.nc` contains a small text header followed by
+ * variables stored in PISM's internal units in the native byte order, exactly as they are
+ * stored in memory. Each process owns a contiguous block of each variable, so a variable
+ * is written and read using one collective MPI-IO call and no re-arrangement of data.
+ *
+ * This is only useful when re-starting on the same grid using the same domain
+ * decomposition, so the NetCDF file records the decomposition (see decomposition()) and
+ * the offset of each variable in the raw file. Variables are always written to the NetCDF
+ * file as well, so it remains usable on its own.
+ *
+ * The raw file contains the last record only: data are overwritten each time a variable
+ * is written.
+ */
+class RawCheckpoint {
+public:
+  typedef std::shared_ptr<RawCheckpoint> Ptr;
+
+  ~RawCheckpoint();
+
+  static Ptr create(const File &file, const IceGrid &grid);
+  static Ptr open(const File &file, const IceGrid &grid);
+
+  static std::string decomposition(const IceGrid &grid);
+
+  void define(const File &file, const SpatialVariableMetadata &variable,
+              unsigned int nlevels);
+
+  void write(const File &file, const SpatialVariableMetadata &variable,
+             unsigned int nlevels, const double *input) const;
+
+  bool read(const File &file, const SpatialVariableMetadata &variable,
+            unsigned int time, unsigned int nlevels, double *output) const;
+private:
+  RawCheckpoint(const IceGrid &grid, const std::string &filename, int mode);
+
+  MPI_Comm m_com;
+  MPI_File m_file;
+  //! Offset of the processor's sub-domain within a 2D field (in grid points)
+  MPI_Offset m_local_offset;
+  //! Size of a 2D field (in grid points)
+  MPI_Offset m_field_size;
+  //! Size of the processor's sub-domain (in grid points)
+  int m_local_size;
+  //! Offset of the end of the data in the raw file (in bytes)
+  MPI_Offset m_end;
+
+  // disable copying and assignments
+  RawCheckpoint(const RawCheckpoint &other);
+  RawCheckpoint & operator=(const RawCheckpoint &);
+};
+
+} // end of namespace pism
+
+#endif /* PISM_RAWCHECKPOINT_H */
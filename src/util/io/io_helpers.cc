@@ -28,6 +28,7 @@
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/ConfigInterface.hh"
 #include "pism/util/io/LocalInterpCtx.hh"
+#include "pism/util/io/RawCheckpoint.hh"
 #include "pism/util/Time.hh"
 #include "pism/util/Logger.hh"
 #include "pism/util/Context.hh"
@@ -45,97 +46,109 @@ namespace io {
  * Note that its inputs are (essentially)
  * - the definition of the input grid
  * - the definition of the output grid
- * - input array (lic->buffer)
+ * - input array (`input_array`, the processor's part of the input, see LocalInterpCtx)
  * - output array (double *output_array)
  *
  * The `output_array` is expected to be big enough to contain
  * `grid.xm()*`grid.ym()*length(zlevels_out)` numbers.
  *
+ * Loops over rows of the processor's sub-domain; within a row indexes and weights in the
+ * x direction are read from contiguous arrays and vertical interpolation (in the 3D case)
+ * uses the innermost loop, so that the compiler can vectorize it.
+ *
  * We should be able to switch to using an external interpolation library
  * fairly easily...
  */
 static void regrid(const IceGrid& grid, const std::vector<double> &zlevels_out,
-                   LocalInterpCtx *lic, double *output_array) {
+                   const LocalInterpCtx &lic, const double *input_array,
+                   double *output_array) {
   // We'll work with the raw storage here so that the array we are filling is
   // indexed the same way as the buffer we are pulling from (input_array)
 
   const int X = 1, Z = 3; // indices, just for clarity
 
-  unsigned int nlevels = zlevels_out.size();
-  double *input_array = &(lic->buffer[0]);
+  const int
+    nlevels = zlevels_out.size(),
+    xm      = grid.xm(),
+    ym      = grid.ym();
 
   // array sizes for mapping from logical to "flat" indices
-  int
-    x_count = lic->count[X],
-    z_count = lic->count[Z];
-
-  for (Points p(grid); p; p.next()) {
-    const int i_global = p.i(), j_global = p.j();
-
-    const int i = i_global - grid.xs(), j = j_global - grid.ys();
-
-    // Indices of neighboring points.
-    const int
-      X_m = lic->x->left(i),
-      X_p = lic->x->right(i),
-      Y_m = lic->y->left(j),
-      Y_p = lic->y->right(j);
-
-    for (unsigned int k = 0; k < nlevels; k++) {
-
-      double
-        a_mm = 0.0,
-        a_mp = 0.0,
-        a_pm = 0.0,
-        a_pp = 0.0;
-
-      if (nlevels > 1) {
-        const int
-          Z_m = lic->z->left(k),
-          Z_p = lic->z->right(k);
-
-        const double alpha_z = lic->z->alpha(k);
-
-        // We pretend that there are always 8 neighbors (4 in the map plane,
-        // 2 vertical levels). And compute the indices into the input_array for
-        // those neighbors.
-        const int
-          mmm = (Y_m * x_count + X_m) * z_count + Z_m,
-          mmp = (Y_m * x_count + X_m) * z_count + Z_p,
-          mpm = (Y_m * x_count + X_p) * z_count + Z_m,
-          mpp = (Y_m * x_count + X_p) * z_count + Z_p,
-          pmm = (Y_p * x_count + X_m) * z_count + Z_m,
-          pmp = (Y_p * x_count + X_m) * z_count + Z_p,
-          ppm = (Y_p * x_count + X_p) * z_count + Z_m,
-          ppp = (Y_p * x_count + X_p) * z_count + Z_p;
-
-        // linear interpolation in the z-direction
-        a_mm = input_array[mmm] * (1.0 - alpha_z) + input_array[mmp] * alpha_z;
-        a_mp = input_array[mpm] * (1.0 - alpha_z) + input_array[mpp] * alpha_z;
-        a_pm = input_array[pmm] * (1.0 - alpha_z) + input_array[pmp] * alpha_z;
-        a_pp = input_array[ppm] * (1.0 - alpha_z) + input_array[ppp] * alpha_z;
-      } else {
-        // we don't need to interpolate vertically for the 2-D case
-        a_mm = input_array[Y_m * x_count + X_m];
-        a_mp = input_array[Y_m * x_count + X_p];
-        a_pm = input_array[Y_p * x_count + X_m];
-        a_pp = input_array[Y_p * x_count + X_p];
+  const int
+    x_count = lic.count[X],
+    z_count = lic.count[Z];
+
+  // indexes and weights in the x direction
+  const int    *x_left  = lic.x->left().data();
+  const int    *x_right = lic.x->right().data();
+  const double *x_alpha = lic.x->alpha().data();
+
+  if (nlevels == 1) {
+    for (int j = 0; j < ym; ++j) {
+      // we don't need to interpolate vertically for the 2-D case
+      const double
+        *row_m = input_array + lic.y->left(j) * x_count,
+        *row_p = input_array + lic.y->right(j) * x_count;
+      const double y_alpha = lic.y->alpha(j);
+
+      double *result = output_array + j * xm;
+
+      for (int i = 0; i < xm; ++i) {
+        const int X_m = x_left[i], X_p = x_right[i];
+
+        // interpolate in x direction
+        const double
+          a_m = row_m[X_m] * (1.0 - x_alpha[i]) + row_m[X_p] * x_alpha[i],
+          a_p = row_p[X_m] * (1.0 - x_alpha[i]) + row_p[X_p] * x_alpha[i];
+
+        // interpolate in y direction
+        result[i] = a_m * (1.0 - y_alpha) + a_p * y_alpha;
       }
+    }
+    return;
+  }
 
-      // interpolation coefficient in the x direction
-      const double x_alpha = lic->x->alpha(i);
-      // interpolation coefficient in the y direction
-      const double y_alpha = lic->y->alpha(j);
-
-      // interpolate in x direction
-      const double a_m = a_mm * (1.0 - x_alpha) + a_mp * x_alpha;
-      const double a_p = a_pm * (1.0 - x_alpha) + a_pp * x_alpha;
+  // indexes and weights in the z direction
+  const int    *z_left  = lic.z->left().data();
+  const int    *z_right = lic.z->right().data();
+  const double *z_alpha = lic.z->alpha().data();
 
-      int index = (j * grid.xm() + i) * nlevels + k;
+  for (int j = 0; j < ym; ++j) {
+    const double
+      *row_m = input_array + lic.y->left(j) * x_count * z_count,
+      *row_p = input_array + lic.y->right(j) * x_count * z_count;
+    const double y_alpha = lic.y->alpha(j);
+
+    for (int i = 0; i < xm; ++i) {
+      // We pretend that there are always 8 neighbors (4 in the map plane, 2 vertical
+      // levels). These are pointers to columns of the four neighbors in the map plane.
+      const double
+        *mm = row_m + x_left[i] * z_count,
+        *mp = row_m + x_right[i] * z_count,
+        *pm = row_p + x_left[i] * z_count,
+        *pp = row_p + x_right[i] * z_count;
+      const double alpha = x_alpha[i];
+
+      double *result = output_array + (j * xm + i) * nlevels;
+
+      for (int k = 0; k < nlevels; ++k) {
+        const int Z_m = z_left[k], Z_p = z_right[k];
+        const double alpha_z = z_alpha[k];
 
-      // index into the new array and interpolate in x direction
-      output_array[index] = a_m * (1.0 - y_alpha) + a_p * y_alpha;
-      // done with the point at (x,y,z)
+        // linear interpolation in the z-direction
+        const double
+          a_mm = mm[Z_m] * (1.0 - alpha_z) + mm[Z_p] * alpha_z,
+          a_mp = mp[Z_m] * (1.0 - alpha_z) + mp[Z_p] * alpha_z,
+          a_pm = pm[Z_m] * (1.0 - alpha_z) + pm[Z_p] * alpha_z,
+          a_pp = pp[Z_m] * (1.0 - alpha_z) + pp[Z_p] * alpha_z;
+
+        // interpolate in x direction
+        const double
+          a_m = a_mm * (1.0 - alpha) + a_mp * alpha,
+          a_p = a_pm * (1.0 - alpha) + a_pp * alpha;
+
+        // interpolate in y direction
+        result[k] = a_m * (1.0 - y_alpha) + a_p * y_alpha;
+      }
     }
   }
 }
@@ -278,10 +291,12 @@ void append_time(const File &file, const std::string &name, double value) {
 static void define_dimensions(const SpatialVariableMetadata& var,
                               const IceGrid& grid, const File &file) {
 
+  const GridWindow &window = file.window();
+
   // x
   std::string x_name = var.get_x().get_name();
   if (not file.find_dimension(x_name)) {
-    define_dimension(file, grid.Mx(), var.get_x());
+    define_dimension(file, window.empty() ? grid.Mx() : window.x_count, var.get_x());
     file.write_attribute(x_name, "spacing_meters", PISM_DOUBLE,
                          {grid.x(1) - grid.x(0)});
     file.write_attribute(x_name, "not_written", PISM_INT, {1.0});
@@ -290,7 +305,7 @@ static void define_dimensions(const SpatialVariableMetadata& var,
   // y
   std::string y_name = var.get_y().get_name();
   if (not file.find_dimension(y_name)) {
-    define_dimension(file, grid.My(), var.get_y());
+    define_dimension(file, window.empty() ? grid.My() : window.y_count, var.get_y());
     file.write_attribute(y_name, "spacing_meters", PISM_DOUBLE,
                          {grid.y(1) - grid.y(0)});
     file.write_attribute(y_name, "not_written", PISM_INT, {1.0});
@@ -339,16 +354,28 @@ static void write_dimension_data(const File &file, const std::string &name,
 
 void write_dimensions(const SpatialVariableMetadata& var,
                       const IceGrid& grid, const File &file) {
+  const GridWindow &window = file.window();
+
   // x
   std::string x_name = var.get_x().get_name();
   if (file.find_dimension(x_name)) {
-    write_dimension_data(file, x_name, grid.x());
+    if (window.empty()) {
+      write_dimension_data(file, x_name, grid.x());
+    } else {
+      auto x = grid.x().begin() + window.x_start;
+      write_dimension_data(file, x_name, std::vector<double>(x, x + window.x_count));
+    }
   }
 
   // y
   std::string y_name = var.get_y().get_name();
   if (file.find_dimension(y_name)) {
-    write_dimension_data(file, y_name, grid.y());
+    if (window.empty()) {
+      write_dimension_data(file, y_name, grid.y());
+    } else {
+      auto y = grid.y().begin() + window.y_start;
+      write_dimension_data(file, y_name, std::vector<double>(y, y + window.y_count));
+    }
   }
 
   // z
@@ -452,9 +479,14 @@ static void regrid_vec_generic(const File &file, const IceGrid &grid,
 
   try {
     grid_info gi(file, variable_name, grid.ctx()->unit_system(), grid.registration());
-    LocalInterpCtx lic(gi, grid, zlevels_out, interpolation_type);
 
-    std::vector<double> &buffer = lic.buffer;
+    profiling.begin("io.regridding.plan");
+    LocalInterpCtx::ConstPtr plan = LocalInterpCtx::get(gi, grid, zlevels_out,
+                                                        interpolation_type);
+    profiling.end("io.regridding.plan");
+    const LocalInterpCtx &lic = *plan;
+
+    std::vector<double> buffer(lic.buffer_size());
 
     const unsigned int t_count = 1;
     std::vector<unsigned int> start, count, imap;
@@ -493,7 +525,7 @@ static void regrid_vec_generic(const File &file, const IceGrid &grid,
 
     // interpolate
     profiling.begin("io.regridding.interpolate");
-    regrid(grid, zlevels_out, &lic, output);
+    regrid(grid, zlevels_out, lic, buffer.data(), output);
     profiling.end("io.regridding.interpolate");
   } catch (RuntimeError &e) {
     e.add_context("reading variable '%s' (using linear interpolation) from '%s'",
@@ -598,6 +630,11 @@ void define_spatial_variable(const SpatialVariableMetadata &var,
     // writing it more than once.
     file.write_attribute(var.get_name(), "not_written", PISM_INT, {1.0});
   }
+
+  RawCheckpoint *raw = file.raw_checkpoint();
+  if (raw != NULL and file.window().empty()) {
+    raw->define(file, var, std::max(var.get_levels().size(), (size_t)1));
+  }
 }
 
 //! Read a variable from a file into an array `output`.
@@ -609,6 +646,16 @@ void read_spatial_variable(const SpatialVariableMetadata &variable,
 
   const Logger &log = *grid.ctx()->log();
 
+  // make sure we have at least one level
+  const std::vector<double>& zlevels = variable.get_levels();
+  unsigned int nlevels = std::max(zlevels.size(), (size_t)1);
+
+  // Raw data are stored in internal units, so there is nothing else to do:
+  RawCheckpoint *raw = file.raw_checkpoint();
+  if (raw != NULL and raw->read(file, variable, time, nlevels, output)) {
+    return;
+  }
+
   // Find the variable:
   auto var = file.find_variable(variable.get_name(), variable.get_string("standard_name"));
 
@@ -663,10 +710,6 @@ void read_spatial_variable(const SpatialVariableMetadata &variable,
     }
   }
 
-  // make sure we have at least one level
-  const std::vector<double>& zlevels = variable.get_levels();
-  unsigned int nlevels = std::max(zlevels.size(), (size_t)1);
-
   read_distributed_array(file, grid, var.name, nlevels, time, output);
 
   std::string input_units = file.read_text_attribute(var.name, "units");
@@ -689,9 +732,70 @@ void read_spatial_variable(const SpatialVariableMetadata &variable,
                    input_units, internal_units).convert_doubles(output, size);
 }
 
+//! Write the part of a distributed array `input` inside the window of `file`.
+/*!
+ * Each process writes the intersection of its sub-domain with the window (possibly
+ * empty).
+ */
+static void write_window(const SpatialVariableMetadata &var,
+                         const IceGrid &grid,
+                         const File &file,
+                         unsigned int nlevels,
+                         const double *input) {
+  const GridWindow &window = file.window();
+
+  const int
+    xs = grid.xs(),
+    xm = grid.xm(),
+    ys = grid.ys(),
+    i0 = std::max(xs, (int)window.x_start),
+    i1 = std::min(xs + xm, (int)(window.x_start + window.x_count)),
+    j0 = std::max(ys, (int)window.y_start),
+    j1 = std::min(ys + grid.ym(), (int)(window.y_start + window.y_count));
+
+  const bool empty = i0 >= i1 or j0 >= j1;
+
+  std::vector<double> buffer;
+  if (not empty) {
+    buffer.reserve((i1 - i0) * (j1 - j0) * nlevels);
+    for (int j = j0; j < j1; ++j) {
+      for (int i = i0; i < i1; ++i) {
+        const double *column = input + ((j - ys) * xm + (i - xs)) * nlevels;
+        buffer.insert(buffer.end(), column, column + nlevels);
+      }
+    }
+  }
+
+  std::vector<unsigned int> start, count;
+
+  if (not var.get_time_independent()) {
+    start.push_back(file.nrecords() - 1);
+    count.push_back(1);
+  }
+
+  // y
+  start.push_back(empty ? 0 : j0 - window.y_start);
+  count.push_back(empty ? 0 : j1 - j0);
+
+  // x
+  start.push_back(empty ? 0 : i0 - window.x_start);
+  count.push_back(empty ? 0 : i1 - i0);
+
+  // z
+  if (file.dimensions(var.get_name()).size() > start.size()) {
+    start.push_back(0);
+    count.push_back(empty ? 0 : nlevels);
+  }
+
+  file.write_variable(var.get_name(), start, count, buffer.data());
+}
+
 //! \brief Write a double array to a file.
 /*!
   Converts units if internal and "glaciological" units are different.
+
+  Writes the part of the array inside the window of `file` if it is set (see
+  File::set_window()).
  */
 void write_spatial_variable(const SpatialVariableMetadata &var,
                             const IceGrid& grid,
@@ -723,16 +827,25 @@ void write_spatial_variable(const SpatialVariableMetadata &var,
   // make sure we have at least one level
   unsigned int nlevels = std::max(var.get_levels().size(), (size_t)1);
 
+  RawCheckpoint *raw = file.raw_checkpoint();
+  if (raw != NULL and file.window().empty()) {
+    // raw data are stored in internal units
+    raw->write(file, var, nlevels, input);
+  }
+
   std::string
     units               = var.get_string("units"),
     glaciological_units = var.get_string("glaciological_units");
 
+  // temporary storage used for unit conversion
+  std::vector<double> tmp;
+
   if (units != glaciological_units) {
     size_t data_size = grid.xm() * grid.ym() * nlevels;
 
     // create a temporary array, convert to glaciological units, and
     // save
-    std::vector<double> tmp(data_size);
+    tmp.resize(data_size);
     for (size_t k = 0; k < data_size; ++k) {
       tmp[k] = input[k];
     }
@@ -741,9 +854,13 @@ void write_spatial_variable(const SpatialVariableMetadata &var,
                      units,
                      glaciological_units).convert_doubles(&tmp[0], tmp.size());
 
-    file.write_distributed_array(name, grid, nlevels, &tmp[0]);
-  } else {
+    input = tmp.data();
+  }
+
+  if (file.window().empty()) {
     file.write_distributed_array(name, grid, nlevels, input);
+  } else {
+    write_window(var, grid, file, nlevels, input);
   }
 }
 
@@ -176,6 +176,37 @@ double GlobalSum(MPI_Comm comm, double local) {
   return result;
 }
 
+static void GlobalReduceLoc(MPI_Comm comm, double local, int local_index,
+                            double &result, int &result_index, MPI_Op op) {
+  struct {
+    double value;
+    int index;
+  } input = {local, local_index}, output;
+
+  int err = MPI_Allreduce(&input, &output, 1, MPI_DOUBLE_INT, op, comm);
+  PISM_C_CHK(err, 0, "MPI_Allreduce");
+
+  result       = output.value;
+  result_index = output.index;
+}
+
+/*!
+ * Compute the global minimum of `local` and the index (e.g. a linear grid index)
+ * corresponding to it.
+ *
+ * If several ranks have the same minimum value the smallest index is returned.
+ */
+void GlobalMinLoc(MPI_Comm comm, double local, int local_index, double &result, int &result_index) {
+  GlobalReduceLoc(comm, local, local_index, result, result_index, MPI_MINLOC);
+}
+
+/*!
+ * Compute the global maximum of `local` and the index corresponding to it.
+ */
+void GlobalMaxLoc(MPI_Comm comm, double local, int local_index, double &result, int &result_index) {
+  GlobalReduceLoc(comm, local, local_index, result, result_index, MPI_MAXLOC);
+}
+
 static const int TEMPORARY_STRING_LENGTH = 32768;
 
 std::string version() {
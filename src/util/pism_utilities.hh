@@ -115,6 +115,10 @@ unsigned int GlobalSum(MPI_Comm comm, unsigned int input);
 
 int GlobalSum(MPI_Comm comm, int input);
 
+void GlobalMinLoc(MPI_Comm comm, double local, int local_index, double &result, int &result_index);
+
+void GlobalMaxLoc(MPI_Comm comm, double local, int local_index, double &result, int &result_index);
+
 std::string version();
 
 std::string printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
@@ -199,3 +199,123 @@ def part_grid_symmetry_test():
     np.testing.assert_almost_equal(H, np.flipud(H))
     np.testing.assert_almost_equal(H, np.fliplr(H))
     np.testing.assert_almost_equal(H, np.flipud(np.fliplr(H)))
+
+
+def dome(thickness, H0, R):
+    "Set ice thickness to a parabolic dome of height H0 and radius R centered at (0,0)."
+
+    grid = thickness.grid()
+
+    with PISM.vec.Access(nocomm=thickness):
+        for (i, j) in grid.points():
+            r = PISM.radius(grid, i, j)
+            thickness[i, j] = H0 * max(1.0 - (r / R)**2, 0.0)
+
+    thickness.update_ghosts()
+
+
+def diffusive_flux(geometry, K, D, Q):
+    """Compute the diffusivity D = K * H (on the staggered grid) and the corresponding
+    explicit diffusive flux Q = -D * grad(s)."""
+
+    grid = D.grid()
+    H = geometry.ice_thickness
+    s = geometry.ice_surface_elevation
+
+    with PISM.vec.Access(nocomm=[H, s], comm=[D, Q]):
+        for (i, j) in grid.points():
+            for o, (i_n, j_n), h in [(0, (i + 1, j), grid.dx()),
+                                     (1, (i, j + 1), grid.dy())]:
+                if i_n < grid.Mx() and j_n < grid.My():
+                    D[i, j, o] = K * 0.5 * (H[i, j] + H[i_n, j_n])
+                    Q[i, j, o] = - D[i, j, o] * (s[i_n, j_n] - s[i, j]) / h
+                else:
+                    D[i, j, o] = 0.0
+                    Q[i, j, o] = 0.0
+
+
+def run_dome(semi_implicit, dt, n_steps):
+    "Evolve a dome using the explicit or the semi-implicit scheme."
+
+    ctx = PISM.Context().ctx
+    config = PISM.Context().config
+
+    config.set_flag("geometry.update.semi_implicit.enabled", semi_implicit)
+    try:
+        L = 100e3
+        grid = PISM.IceGrid_Shallow(ctx, L, L, 0, 0, 41, 41,
+                                    PISM.CELL_CORNER, PISM.NOT_PERIODIC)
+
+        geometry = PISM.Geometry(grid)
+        ge = PISM.GeometryEvolution(grid)
+    finally:
+        config.set_flag("geometry.update.semi_implicit.enabled", False)
+
+    geometry.latitude.set(0.0)
+    geometry.longitude.set(0.0)
+    geometry.bed_elevation.set(0.0)
+    geometry.sea_level_elevation.set(-1000.0)
+    dome(geometry.ice_thickness, 1000.0, 0.6 * L)
+    geometry.ice_area_specific_volume.set(0.0)
+    geometry.ensure_consistency(0.0)
+
+    v         = PISM.IceModelVec2V(grid, "velocity", PISM.WITHOUT_GHOSTS)
+    D         = PISM.IceModelVec2Stag(grid, "D", PISM.WITH_GHOSTS)
+    Q         = PISM.IceModelVec2Stag(grid, "Q", PISM.WITH_GHOSTS)
+    v_bc_mask = PISM.IceModelVec2Int(grid, "v_bc_mask", PISM.WITHOUT_GHOSTS)
+    H_bc_mask = PISM.IceModelVec2Int(grid, "H_bc_mask", PISM.WITHOUT_GHOSTS)
+
+    v.set(0.0)
+    v_bc_mask.set(0.0)
+    H_bc_mask.set(0.0)
+
+    for _ in range(n_steps):
+        diffusive_flux(geometry, K, D, Q)
+
+        flux = Q
+        if semi_implicit:
+            flux = ge.semi_implicit_diffusive_flux(geometry, dt, D, Q, H_bc_mask)
+
+        ge.flow_step(geometry, dt, v, flux, v_bc_mask, H_bc_mask)
+        ge.apply_flux_divergence(geometry)
+        geometry.ensure_consistency(0.0)
+
+    return geometry.ice_thickness.numpy()
+
+
+# diffusivity per unit ice thickness, m s-1 (D_max = 1 m2 s-1)
+K = 1e-3
+# time step length allowed by the explicit scheme (grid spacing of 5 km)
+dt_explicit = (5e3)**2 / (4.0 * K * 1000.0)
+
+
+def semi_implicit_vs_explicit_test():
+    "The semi-implicit scheme should agree with the explicit one on a dome."
+
+    log.disable()
+    H0 = run_dome(False, 0.0, 0)
+    H_explicit = run_dome(False, 0.1 * dt_explicit, 20)
+    H_semi_implicit = run_dome(True, 0.1 * dt_explicit, 20)
+    log.enable()
+
+    change = np.max(np.abs(H_explicit - H0))
+    assert change > 1.0
+
+    error = np.max(np.abs(H_semi_implicit - H_explicit))
+    assert error < 0.1 * change, (error, change)
+
+    # both schemes conserve mass
+    np.testing.assert_allclose(np.sum(H_semi_implicit), np.sum(H_explicit), rtol=1e-3)
+
+
+def semi_implicit_stability_test():
+    """The semi-implicit scheme should remain stable (and satisfy the maximum principle)
+    using time steps much longer than the explicit limit."""
+
+    log.disable()
+    H = run_dome(True, 20.0 * dt_explicit, 5)
+    log.enable()
+
+    assert np.all(np.isfinite(H))
+    assert np.min(H) >= 0.0
+    assert np.max(H) <= 1000.0
@@ -1165,6 +1165,142 @@ def checksum_test():
 
     assert old_checksum != v.checksum()
 
+def compact_mask_test():
+    "Compare CompactMask::update_ghosts() to IceModelVec2Int::update_ghosts()"
+    ctx = PISM.Context()
+    params = PISM.GridParameters(ctx.config)
+    params.Lx = 1e5
+    params.Ly = 1e5
+    params.Lz = 1000
+    params.Mx = 23
+    params.My = 17
+    params.Mz = 2
+    params.registration = PISM.CELL_CENTER
+    params.periodicity = PISM.XY_PERIODIC
+    params.ownership_ranges_from_options(ctx.size)
+    grid = PISM.IceGrid(ctx.ctx, params)
+
+    w = 2
+    mask = PISM.IceModelVec2Int(grid, "mask", PISM.WITH_GHOSTS, w)
+    compact = PISM.CompactMask(grid, "compact_mask", w)
+
+    mask.set(-1)
+    compact.set(-1)
+
+    # use values that are different at every point and cover the range of int8_t
+    with PISM.vec.Access(comm=[mask, compact]):
+        for (i, j) in grid.points():
+            value = (i + grid.Mx() * j) % 256 - 128
+            mask[i, j] = value
+            compact[i, j] = value
+
+    def check(a, b):
+        with PISM.vec.Access(nocomm=[a, b]):
+            for j in range(grid.ys() - w, grid.ys() + grid.ym() + w):
+                for i in range(grid.xs() - w, grid.xs() + grid.xm() + w):
+                    assert b[i, j] == int(a[i, j]), (i, j, a[i, j], b[i, j])
+
+    check(mask, compact)
+
+    # copy_from() fills ghosts, too
+    copy = PISM.CompactMask(grid, "copy", w)
+    copy.copy_from(mask)
+    check(mask, copy)
+
+    # copy_to() round trip
+    result = PISM.IceModelVec2Int(grid, "result", PISM.WITH_GHOSTS, w)
+    compact.copy_to(result)
+    check(result, compact)
+
+def ragged_columns_test():
+    "RaggedColumns: column sizes, get_column/set_column round trips, conversion to IceModelVec3"
+    ctx = PISM.Context()
+    params = PISM.GridParameters(ctx.config)
+    params.Lx = 1e5
+    params.Ly = 1e5
+    params.Lz = 1000
+    params.Mx = 5
+    params.My = 7
+    params.Mz = 11
+    params.registration = PISM.CELL_CORNER
+    params.periodicity = PISM.NOT_PERIODIC
+    params.ownership_ranges_from_options(ctx.size)
+    grid = PISM.IceGrid(ctx.ctx, params)
+    Lz = grid.Lz()
+    Mz = grid.Mz()
+
+    H = PISM.IceModelVec2S(grid, "thk", PISM.WITHOUT_GHOSTS)
+    with PISM.vec.Access(nocomm=H):
+        for (i, j) in grid.points():
+            # includes ice-free columns and columns thicker than the domain
+            H[i, j] = (i + j) * 0.25 * Lz
+
+    ragged = PISM.RaggedColumns(grid, "ragged")
+
+    fill_value = -1.0
+    ragged.update_columns(H, fill_value)
+    ragged.set(fill_value)
+
+    def expected_levels(i, j):
+        return grid.kBelowHeight(max(min(H[i, j], Lz), 0.0)) + 1
+
+    def values(i, j, n):
+        return [1000.0 * i + 100.0 * j + k for k in range(n)]
+
+    total = 0
+    with PISM.vec.Access(nocomm=[H, ragged]):
+        for (i, j) in grid.points():
+            n = ragged.n_levels(i, j)
+            assert n == expected_levels(i, j), (i, j, n)
+            total += n
+
+            np.testing.assert_equal(ragged.get_column(i, j), [fill_value] * n)
+
+            ragged.set_column(i, j, values(i, j, n))
+
+        for (i, j) in grid.points():
+            np.testing.assert_equal(ragged.get_column(i, j), values(i, j, ragged.n_levels(i, j)))
+
+    assert ragged.size() == total
+
+    # conversion to IceModelVec3 fills levels above the ice
+    output = PISM.IceModelVec3(grid, "output", PISM.WITHOUT_GHOSTS)
+    ragged.copy_to(output, fill_value)
+    with PISM.vec.Access(nocomm=[output, ragged]):
+        for (i, j) in grid.points():
+            n = ragged.n_levels(i, j)
+            np.testing.assert_equal(output.get_column_vector(i, j),
+                                    values(i, j, n) + [fill_value] * (Mz - n))
+
+    # round trip through IceModelVec3
+    copy = PISM.RaggedColumns(grid, "copy")
+    copy.update_columns(H, 0.0)
+    copy.copy_from(output)
+    with PISM.vec.Access(nocomm=[copy]):
+        for (i, j) in grid.points():
+            np.testing.assert_equal(copy.get_column(i, j), values(i, j, copy.n_levels(i, j)))
+
+    # thinning the ice keeps values at remaining levels, thickening fills new levels with
+    # the value at the top of the column
+    H.scale(0.5)
+    ragged.update_columns(H, fill_value)
+    with PISM.vec.Access(nocomm=[H, ragged]):
+        for (i, j) in grid.points():
+            n = ragged.n_levels(i, j)
+            assert n == expected_levels(i, j)
+            np.testing.assert_equal(ragged.get_column(i, j), values(i, j, n))
+
+    H.scale(4.0)
+    ragged.update_columns(H, fill_value)
+    with PISM.vec.Access(nocomm=[H, ragged]):
+        for (i, j) in grid.points():
+            # the thickness was 4 times smaller before this update
+            n_old = grid.kBelowHeight(max(min(H[i, j] / 4.0, Lz), 0.0)) + 1
+            n = ragged.n_levels(i, j)
+            column = values(i, j, n_old)
+            np.testing.assert_equal(ragged.get_column(i, j),
+                                    column + [column[-1]] * (n - n_old))
+
 class ForcingOptions(TestCase):
     def setUp(self):
         # store current configuration parameters
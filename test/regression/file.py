@@ -42,6 +42,195 @@ def test_string_to_backend():
     except RuntimeError:
         pass
 
+def test_windowed_output():
+    "Write a part of the grid (File.set_window()) and read it back"
+    grid = PISM.testing.shallow_grid(Mx=7, My=9)
+
+    vec = PISM.IceModelVec2S(grid, "v", PISM.WITHOUT_GHOSTS)
+    vec.set_attrs("testing", "dummy variable for testing", "1", "1", "", 0)
+    vec.set_time_independent(True)
+
+    with PISM.vec.Access(nocomm=vec):
+        for (i, j) in grid.points():
+            vec[i, j] = 100 * i + j
+
+    x_start, x_count, y_start, y_count = 2, 3, 1, 5
+    window = PISM.GridWindow(x_start, x_count, y_start, y_count)
+
+    filename = "test_windowed_output.nc"
+    for backend in backends:
+        if not PISM.supports_windows(backend):
+            continue
+
+        f = PISM.File(ctx.com(), filename, backend, PISM.PISM_READWRITE_CLOBBER,
+                      ctx.pio_iosys_id())
+        f.set_window(window)
+        vec.write(f)
+        f.close()
+
+        f = PISM.File(ctx.com(), filename, PISM.PISM_NETCDF3, PISM.PISM_READONLY)
+
+        assert f.dimension_length("x") == x_count
+        assert f.dimension_length("y") == y_count
+
+        x = f.read_dimension("x")
+        y = f.read_dimension("y")
+        for k in range(x_count):
+            assert x[k] == grid.x(x_start + k)
+        for k in range(y_count):
+            assert y[k] == grid.y(y_start + k)
+
+        # variables are stored as (y, x)
+        data = f.read_variable("v", [0, 0], [y_count, x_count])
+        for j in range(y_count):
+            for i in range(x_count):
+                if data[j * x_count + i] != 100 * (x_start + i) + (y_start + j):
+                    fail(backend)
+
+        f.close()
+
+    os.remove(filename)
+
+def test_windowed_output_pio():
+    "ParallelIO backends do not support windows"
+    for backend in [PISM.PISM_PIO_PNETCDF, PISM.PISM_PIO_NETCDF,
+                    PISM.PISM_PIO_NETCDF4C, PISM.PISM_PIO_NETCDF4P]:
+        assert not PISM.supports_windows(backend)
+
+    for backend in [PISM.PISM_NETCDF3, PISM.PISM_NETCDF4_PARALLEL, PISM.PISM_PNETCDF]:
+        assert PISM.supports_windows(backend)
+
+    filename = "test_windowed_output_pio.nc"
+    for backend in backends:
+        if PISM.supports_windows(backend):
+            continue
+
+        f = PISM.File(ctx.com(), filename, backend, PISM.PISM_READWRITE_CLOBBER,
+                      ctx.pio_iosys_id())
+        try:
+            f.set_window(PISM.GridWindow(0, 1, 0, 1))
+            fail(backend)
+        except RuntimeError:
+            pass
+        finally:
+            f.close()
+            os.remove(filename)
+
+class RawCheckpoint(TestCase):
+    "Writing and reading raw checkpoints (see output.raw_checkpoint)"
+
+    def create_grid(self, Mx=7, My=9):
+        params = PISM.GridParameters(ctx.config())
+        params.Lx = 1e5
+        params.Ly = 1e5
+        params.Lz = 1000
+        params.Mx = Mx
+        params.My = My
+        params.Mz = 5
+        params.registration = PISM.CELL_CORNER
+        params.periodicity = PISM.NOT_PERIODIC
+        params.ownership_ranges_from_options(ctx.size())
+        return PISM.IceGrid(ctx, params)
+
+    def create_vecs(self, grid):
+        v2 = PISM.IceModelVec2S(grid, "v2", PISM.WITHOUT_GHOSTS)
+        v2.set_attrs("testing", "2D test variable", "1", "1", "", 0)
+        v2.set_time_independent(True)
+
+        v3 = PISM.IceModelVec3(grid, "v3", PISM.WITHOUT_GHOSTS)
+        v3.set_attrs("testing", "3D test variable", "1", "1", "", 0)
+        v3.set_time_independent(True)
+
+        return v2, v3
+
+    def value(self, i, j, k=0):
+        return 100.0 * i + 10.0 * j + k
+
+    def read(self, grid, use_raw):
+        "Read test variables, using the raw checkpoint if `use_raw` is set."
+        v2, v3 = self.create_vecs(grid)
+
+        f = PISM.File(ctx.com(), self.filename, PISM.PISM_NETCDF3, PISM.PISM_READONLY)
+        if use_raw:
+            raw = PISM.RawCheckpoint.open(f, grid)
+            assert raw is not None
+            f.set_raw_checkpoint(raw)
+        v2.read(f, 0)
+        v3.read(f, 0)
+        f.close()
+
+        return v2, v3
+
+    def check(self, v2, v3, v2_value=None):
+        "Check values of test variables. Use `v2_value` instead of the original data if set."
+        grid = v2.grid()
+        with PISM.vec.Access(nocomm=[v2, v3]):
+            for (i, j) in grid.points():
+                expected = v2_value if v2_value is not None else self.value(i, j)
+                assert v2[i, j] == expected, (i, j, v2[i, j], expected)
+                for k in range(grid.Mz()):
+                    assert v3[i, j, k] == self.value(i, j, k)
+
+    def setUp(self):
+        self.filename = "test_raw_checkpoint.nc"
+        self.raw_filename = self.filename + ".raw"
+        self.grid = self.create_grid()
+
+        v2, v3 = self.create_vecs(self.grid)
+        with PISM.vec.Access(nocomm=[v2, v3]):
+            for (i, j) in self.grid.points():
+                v2[i, j] = self.value(i, j)
+                for k in range(self.grid.Mz()):
+                    v3[i, j, k] = self.value(i, j, k)
+
+        f = PISM.File(ctx.com(), self.filename, PISM.PISM_NETCDF3, PISM.PISM_READWRITE_CLOBBER)
+        f.set_raw_checkpoint(PISM.RawCheckpoint.create(f, self.grid))
+        v2.write(f)
+        v3.write(f)
+        f.close()
+
+        # modify v2 in the NetCDF file only to tell which file was read
+        f = PISM.File(ctx.com(), self.filename, PISM.PISM_NETCDF3, PISM.PISM_READWRITE)
+        Mx, My = self.grid.Mx(), self.grid.My()
+        f.write_variable("v2", [0, 0], [My, Mx], [-1.0] * (Mx * My))
+        f.close()
+
+    def tearDown(self):
+        for f in [self.filename, self.raw_filename]:
+            if os.path.exists(f):
+                os.remove(f)
+
+    def test_round_trip(self):
+        "Raw checkpoint: write/read round trip"
+        v2, v3 = self.read(self.grid, use_raw=True)
+        self.check(v2, v3)
+
+    def test_netcdf(self):
+        "Raw checkpoint: NetCDF data are read if the raw checkpoint is not used"
+        v2, v3 = self.read(self.grid, use_raw=False)
+        self.check(v2, v3, v2_value=-1.0)
+
+    def test_different_grid(self):
+        "Raw checkpoint: a raw checkpoint is not used with a different grid"
+        grid = self.create_grid(Mx=8)
+        f = PISM.File(ctx.com(), self.filename, PISM.PISM_NETCDF3, PISM.PISM_READONLY)
+        assert PISM.RawCheckpoint.open(f, grid) is None
+        f.close()
+
+    def test_missing_file(self):
+        "Raw checkpoint: missing raw file"
+        os.remove(self.raw_filename)
+        f = PISM.File(ctx.com(), self.filename, PISM.PISM_NETCDF3, PISM.PISM_READONLY)
+        assert PISM.RawCheckpoint.open(f, self.grid) is None
+        f.close()
+
+    def test_truncated_file(self):
+        "Raw checkpoint: truncated raw file (fall back to NetCDF)"
+        # keep the header (1024 bytes) and a part of the first variable
+        os.truncate(self.raw_filename, 1024 + 8)
+        v2, v3 = self.read(self.grid, use_raw=True)
+        self.check(v2, v3, v2_value=-1.0)
+
 class File(TestCase):
 
     def test_empty_filename(self):
@@ -612,3 +801,190 @@ netcdf string_attribute_test {{
     def tearDown(self):
         os.remove(self.basename + ".nc")
         os.remove(self.basename + ".cdl")
+
+class StorageSettings(TestCase):
+    "Chunking, compression and quantization of spatial variables in NetCDF-4 files"
+
+    def setUp(self):
+        if not PISM.Pism_USE_PARALLEL_NETCDF4:
+            raise SkipTest("PISM was built without parallel NetCDF-4")
+
+        self.filename = "test_storage_settings.nc"
+        self.files = [self.filename]
+
+    def tearDown(self):
+        for f in self.files:
+            if os.path.exists(f):
+                os.remove(f)
+
+    def define(self, storage, backend=PISM.PISM_NETCDF4_PARALLEL, Mx=50, My=40):
+        "Define variables with and without the time dimension, then close the file."
+        f = PISM.File(ctx.com(), self.filename, backend, PISM.PISM_READWRITE_CLOBBER)
+        f.set_storage_settings(storage)
+        f.define_dimension("time", PISM.PISM_UNLIMITED)
+        f.define_dimension("y", My)
+        f.define_dimension("x", Mx)
+        f.define_variable("map", PISM.PISM_FLOAT, ["y", "x"])
+        f.define_variable("series", PISM.PISM_FLOAT, ["time", "y", "x"])
+        f.define_variable("scalar", PISM.PISM_DOUBLE, ["time"])
+        f.close()
+
+    def variables(self):
+        import netCDF4
+        return netCDF4.Dataset(self.filename).variables
+
+    def test_chunking_map(self):
+        "Storage settings: 'map' chunking"
+        storage = PISM.StorageSettings(ctx.config())
+        storage.chunking = PISM.string_to_chunking("map")
+        self.define(storage)
+
+        v = self.variables()
+        assert v["map"].chunking() == [40, 50]
+        # one record per chunk
+        assert v["series"].chunking() == [1, 40, 50]
+
+    def test_chunking_time_series(self):
+        "Storage settings: 'time_series' chunking"
+        storage = PISM.StorageSettings(ctx.config())
+        storage.chunking = PISM.string_to_chunking("time_series")
+        self.define(storage)
+
+        v = self.variables()
+        assert v["map"].chunking() == [32, 32]
+        assert v["series"].chunking() == [64, 32, 32]
+
+    def test_chunking_large_maps(self):
+        "Storage settings: chunks of large maps fit in the chunk cache"
+        storage = PISM.StorageSettings(ctx.config())
+        storage.chunking = PISM.string_to_chunking("map")
+        # 1100 * 1000 * 4 bytes exceed 4 MiB; the longer side is split in half
+        self.define(storage, Mx=1000, My=1100)
+
+        assert self.variables()["series"].chunking() == [1, 550, 1000]
+
+    def test_string_to_chunking(self):
+        "string_to_chunking()"
+        try:
+            PISM.string_to_chunking("invalid")
+            assert False, "failed to reject an invalid chunking type"
+        except RuntimeError:
+            pass
+
+    def test_deflate(self):
+        "Storage settings: deflate compression"
+        storage = PISM.StorageSettings(ctx.config())
+        storage.compression_level = 3
+        storage.shuffle = True
+        self.define(storage)
+
+        v = self.variables()
+        for name in ["map", "series"]:
+            filters = v[name].filters()
+            assert filters["zlib"]
+            assert filters["complevel"] == 3
+            assert filters["shuffle"]
+
+        storage.compression_level = 0
+        self.define(storage)
+        assert not self.variables()["series"].filters()["zlib"]
+
+    def test_invalid_compression_level(self):
+        "Storage settings: invalid compression levels are rejected"
+        config = ctx.config()
+        level = config.get_number("output.netcdf4.compression_level")
+        config.set_number("output.netcdf4.compression_level", 10)
+        try:
+            PISM.StorageSettings(config)
+            assert False, "failed to reject compression_level == 10"
+        except RuntimeError:
+            pass
+        finally:
+            config.set_number("output.netcdf4.compression_level", level)
+
+    def test_quantization(self):
+        "Storage settings: quantization"
+        storage = PISM.StorageSettings(ctx.config())
+        storage.significant_bits = 8
+        try:
+            self.define(storage, Mx=5, My=4)
+        except RuntimeError as e:
+            if "NetCDF 4.9.0" in str(e):
+                raise SkipTest(str(e))
+            raise
+
+        f = PISM.File(ctx.com(), self.filename, PISM.PISM_NETCDF4_PARALLEL, PISM.PISM_READWRITE)
+        f.write_variable("map", [0, 0], [4, 5], [1.0 / (k + 3.0) for k in range(20)])
+        f.close()
+
+        v = self.variables()["map"]
+        assert v.getncattr("_QuantizeBitRoundNumberOfSignificantBits") == 8
+        check_quantized(v[:], 8)
+
+    def test_quantization_netcdf3(self):
+        "Storage settings: quantization is ignored by NetCDF-3 files"
+        storage = PISM.StorageSettings(ctx.config())
+        storage.significant_bits = 8
+        self.define(storage, backend=PISM.PISM_NETCDF3)
+
+        assert "_QuantizeBitRoundNumberOfSignificantBits" not in self.variables()["map"].ncattrs()
+
+    def run_pisms(self, output_format, significant_bits, chunking="map"):
+        "Run pisms saving -extra_file output. Returns its standard output and error."
+        import subprocess
+
+        pisms = os.path.join(os.getcwd(), "pisms")
+        if not os.path.exists(pisms):
+            raise SkipTest("pisms is not in the current directory")
+
+        extra_file = "test_storage_settings_extra.nc"
+        output_file = "test_storage_settings_output.nc"
+        self.files += [extra_file, output_file]
+        self.filename = extra_file
+
+        command = [pisms, "-config", "pism_config.nc",
+                   "-Mx", "11", "-My", "11", "-Mz", "11", "-y", "200", "-verbose", "2",
+                   "-o", output_file, "-o_format", output_format,
+                   "-extra_file", extra_file, "-extra_times", "100", "-extra_vars", "thk",
+                   "-output.extra.chunking", chunking,
+                   "-output.netcdf4.significant_bits", str(significant_bits)]
+
+        result = subprocess.run(command, stdout=subprocess.PIPE,
+                                stderr=subprocess.STDOUT, universal_newlines=True)
+        assert result.returncode == 0, result.stdout
+
+        return result.stdout
+
+    def test_extra_file_quantization(self):
+        "Storage settings: -extra_file output is quantized"
+        try:
+            self.run_pisms("netcdf4_parallel", 8, chunking="time_series")
+        except AssertionError as e:
+            if "NetCDF 4.9.0" in str(e):
+                raise SkipTest("quantization requires NetCDF 4.9.0 or newer")
+            raise
+
+        v = self.variables()
+        thk = v["thk"]
+        assert thk.getncattr("_QuantizeBitRoundNumberOfSignificantBits") == 8
+        assert thk.chunking() == [64, 11, 11]
+        check_quantized(thk[:], 8)
+
+        # output files are never quantized
+        self.filename = "test_storage_settings_output.nc"
+        assert "_QuantizeBitRoundNumberOfSignificantBits" not in self.variables()["thk"].ncattrs()
+
+    def test_extra_file_quantization_netcdf3(self):
+        "Storage settings: quantization of -extra_file output is ignored with a warning (NetCDF-3)"
+        output = self.run_pisms("netcdf3", 8)
+
+        assert "output.format 'netcdf3' cannot store quantized variables" in output
+        assert "_QuantizeBitRoundNumberOfSignificantBits" not in self.variables()["thk"].ncattrs()
+
+def check_quantized(data, significant_bits):
+    "Check that bits of single precision values beyond `significant_bits` are zero."
+    import numpy as np
+
+    bits = np.ma.filled(data, 0.0).astype(np.float32).view(np.uint32)
+    mask = (1 << (23 - significant_bits)) - 1
+    assert np.all(bits & mask == 0)
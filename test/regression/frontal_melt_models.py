@@ -4,6 +4,7 @@ Tests of PISM's frontal melt models.
 """
 
 import PISM
+import PISM.testing
 from PISM.util import convert
 import sys, os, numpy
 from unittest import TestCase
@@ -217,6 +218,56 @@ class GivenTest(TestCase):
     def tearDown(self):
         os.remove(self.filename)
 
+class GivenMovingFrontTest(TestCase):
+    "Model Given: the ice front moves while the same forcing record is active"
+    def setUp(self):
+        self.frontal_melt_rate = 100.0
+
+        self.grid = create_grid()
+        self.geometry = create_geometry(self.grid)
+
+        self.filename = "given_moving_front_input.nc"
+
+        one_year = convert(1.0, "year", "second")
+
+        # two records, so that the model has to use IceModelVec2T::average()
+        PISM.testing.create_forcing(self.grid, self.filename, "frontal_melt_rate", "m / s",
+                                    [self.frontal_melt_rate, self.frontal_melt_rate],
+                                    time_bounds=[0, 10 * one_year, 20 * one_year])
+
+        config.set_string("frontal_melt.given.file", self.filename)
+
+        self.water_flux = PISM.IceModelVec2S(self.grid, "water_flux", PISM.WITHOUT_GHOSTS)
+        self.water_flux.set(0.0)
+
+        self.inputs = PISM.FrontalMeltInputs()
+        self.inputs.geometry = self.geometry
+        self.inputs.subglacial_water_flux = self.water_flux
+
+        self.dt = one_year
+
+    def set_ice_thickness(self, H):
+        self.geometry.bed_elevation.set(-100.0)
+        self.geometry.ice_thickness.set(H)
+        self.geometry.ensure_consistency(0.0)
+
+    def runTest(self):
+        model = PISM.FrontalMeltGiven(self.grid)
+        model.init(self.geometry)
+
+        # ice-free ocean: frontal melt rate is zero everywhere
+        self.set_ice_thickness(0.0)
+        model.update(self.inputs, 0, self.dt)
+        check_model(model, 0.0)
+
+        # grounded ice everywhere: the same record is active, but the mask changed
+        self.set_ice_thickness(1000.0)
+        model.update(self.inputs, self.dt, self.dt)
+        check_model(model, self.frontal_melt_rate)
+
+    def tearDown(self):
+        os.remove(self.filename)
+
 if __name__ == "__main__":
 
     t = DischargeRoutingTest()
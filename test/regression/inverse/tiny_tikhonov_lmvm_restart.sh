@@ -0,0 +1,71 @@
+#!/bin/bash
+# Tests checkpointing and restarting an inversion.
+# Requires PISM's Python bindings
+PYTHONEXEC=$5
+PISM_BUILD_DIR=$1
+
+# make sure that Python imports the right modules
+export PYTHONPATH=${PISM_BUILD_DIR}/site-packages:$PYTHONPATH
+
+set -x
+set -e
+
+# Create input files
+$PYTHONEXEC build_tiny.py -Mx 9 -My 9
+
+$PYTHONEXEC make_synth_ssa.py -i tiny.nc -o inv_data.nc \
+              -pseudo_plastic -pseudo_plastic_q 0.25 -regional \
+              -ssa_dirichlet_bc -generate_ssa_observed -ssa_method fem \
+              -design_prior_const 70000 -inv_ssa tauc
+
+options="-i tiny.nc -pseudo_plastic -pseudo_plastic_q 0.25 -inv_data inv_data.nc \
+         -o tiny_restart.nc -regional -ssa_dirichlet_bc -inv_use_tauc_prior \
+         -inv_design_param trunc -inv_design_cL2 1 -inv_design_cH1 0 \
+         -inv_method tikhonov_lmvm -tikhonov_penalty 6e-2 \
+         -inv_checkpoint_file tiny_checkpoint.nc -inv_checkpoint_interval 3"
+
+# Uninterrupted inversion (reference)
+$PYTHONEXEC pismi.py $options -inv_max_it 100 -o tiny_full.nc \
+            -inv_checkpoint_file tiny_full_checkpoint.nc
+
+# Stop the inversion after 6 iterations, saving checkpoints at iterations 3 and 6
+$PYTHONEXEC pismi.py $options -inv_max_it 6
+
+# Check the checkpoint: iteration counter, design, velocity and the L-BFGS history
+$PYTHONEXEC - <<END
+import netCDF4, sys
+f = netCDF4.Dataset("tiny_checkpoint.nc")
+assert f.inverse_iteration == 6, f.inverse_iteration
+assert f.inverse_history_length == 5, f.inverse_history_length
+for name in ["zeta_inv", "u_ssa_inv", "v_ssa_inv"]:
+    assert name in f.variables, name
+for k in range(f.inverse_history_length):
+    assert "zeta_history_%d" % k in f.variables
+    assert "gradient_history_%d" % k in f.variables
+END
+
+# Resume from the checkpoint
+$PYTHONEXEC pismi.py $options -inv_max_it 100 -inv_restart > restart.log
+cat restart.log
+
+grep -q "restarting from iteration 6" restart.log
+grep -q "restored 5 quasi-Newton updates" restart.log
+
+# The restarted run has to continue the L-BFGS iteration of the uninterrupted one: its
+# misfit history (starting at iteration 6) reproduces the reference one. A restart that
+# loses the history takes a steepest descent step instead and diverges from it.
+$PYTHONEXEC - <<END
+import netCDF4, numpy
+full = netCDF4.Dataset("tiny_full.nc").variables["inv_ssa_misfit"][:]
+restarted = netCDF4.Dataset("tiny_restart.nc").variables["inv_ssa_misfit"][:]
+N = min(4, len(restarted), len(full) - 6)
+assert N > 1, (len(full), len(restarted))
+print("reference:", full[6:6 + N])
+print("restarted:", restarted[:N])
+numpy.testing.assert_allclose(restarted[:N], full[6:6 + N], rtol=1e-3)
+assert len(restarted) + 6 <= len(full) + 1, (len(full), len(restarted))
+END
+
+# Check if we succeeded: the inversion converges and the restarted run continues the
+# L-BFGS iteration instead of starting from scratch
+$PYTHONEXEC verify_ssa_inv.py tiny_restart.nc --desired_misfit 10 --misfit_tolerance .5 --iter_max 94
@@ -199,6 +199,120 @@ class GivenTHTest(TestCase):
     def tearDown(self):
         os.remove(self.filename)
 
+class GivenTHShelfCellsTest(TestCase):
+    "GivenTH: the three-equation model is solved under ice shelves and next to them only"
+
+    def setUp(self):
+        self.grid = shallow_grid(Mx=9, My=7)
+        self.filename = "ocean_given_th_shelf_cells_input.nc"
+
+        grid = self.grid
+
+        PISM.util.prepare_output(self.filename)
+
+        Th = PISM.IceModelVec2S(grid, "theta_ocean", PISM.WITHOUT_GHOSTS)
+        Th.set_attrs("climate", "potential temperature", "Kelvin", "Kelvin", "", 0)
+
+        S = PISM.IceModelVec2S(grid, "salinity_ocean", PISM.WITHOUT_GHOSTS)
+        S.set_attrs("climate", "ocean salinity", "g/kg", "g/kg", "", 0)
+
+        # spatially-variable inputs make sure that outputs are computed at the right points
+        with PISM.vec.Access(nocomm=[Th, S]):
+            for (i, j) in grid.points():
+                Th[i, j] = 270.0 + 0.1 * i
+                S[i, j] = 34.0 + 0.1 * j
+
+        Th.write(self.filename)
+        S.write(self.filename)
+
+        config.set_string("ocean.th.file", self.filename)
+
+        # the ice-free ocean cell at the calving front of grounded ice
+        self.ocean = (4, 3)
+
+    def create_geometry(self, grounded):
+        """Floating ice everywhere except for an ice-free ocean cell. If `grounded` is set,
+        ice in columns 2 to 6 is grounded (the ice-free cell is in this part)."""
+        geometry = PISM.Geometry(self.grid)
+
+        geometry.sea_level_elevation.set(0.0)
+
+        with PISM.vec.Access(nocomm=[geometry.ice_thickness, geometry.bed_elevation]):
+            for (i, j) in self.grid.points():
+                geometry.ice_thickness[i, j] = 500.0 + 10.0 * (i + j)
+                geometry.bed_elevation[i, j] = 100.0 if grounded and 2 <= i <= 6 else -2000.0
+
+                if (i, j) == self.ocean:
+                    geometry.ice_thickness[i, j] = 0.0
+                    geometry.bed_elevation[i, j] = -2000.0
+
+        geometry.ensure_consistency(0.0)
+
+        return geometry
+
+    def outputs(self, geometry):
+        model = PISM.OceanGivenTH(self.grid)
+        model.init(geometry)
+        model.update(geometry, 0, 1)
+
+        T = model.shelf_base_temperature()
+        M = model.shelf_base_mass_flux()
+
+        result = {}
+        with PISM.vec.Access(nocomm=[T, M]):
+            for (i, j) in self.grid.points():
+                result[(i, j)] = (T[i, j], M[i, j])
+        return result
+
+    def test_shelf_cells(self):
+        "Model GivenTH: floating ice and its neighbors"
+        Mx, My = self.grid.Mx(), self.grid.My()
+
+        # all cells are either floating or next to floating ice, so outputs are computed
+        # everywhere (as in the full-grid computation)
+        reference = self.outputs(self.create_geometry(grounded=False))
+
+        geometry = self.create_geometry(grounded=True)
+        outputs = self.outputs(geometry)
+
+        cell_type = {}
+        with PISM.vec.Access(nocomm=geometry.cell_type):
+            for (i, j) in self.grid.points():
+                cell_type[(i, j)] = geometry.cell_type[i, j]
+
+        # neighbors of a cell (note that ghosts of the cell type mask are periodic)
+        def neighbors(i, j, offsets):
+            return [cell_type[((i + di) % Mx, (j + dj) % My)] for di, dj in offsets]
+
+        box = [(di, dj) for di in [-1, 0, 1] for dj in [-1, 0, 1] if (di, dj) != (0, 0)]
+        star = [(1, 0), (-1, 0), (0, 1), (0, -1)]
+
+        T_melting = config.get_number("constants.fresh_water.melting_point_temperature")
+
+        n_shelf_cells = 0
+        for (i, j) in self.grid.points():
+            M = cell_type[(i, j)]
+
+            floating = M == PISM.MASK_FLOATING
+            next_to_floating_ice = PISM.MASK_FLOATING in neighbors(i, j, box)
+            ocean_next_to_ice = (M == PISM.MASK_ICE_FREE_OCEAN and
+                                 any(n in [PISM.MASK_GROUNDED, PISM.MASK_FLOATING]
+                                     for n in neighbors(i, j, star)))
+
+            if floating or next_to_floating_ice or ocean_next_to_ice:
+                n_shelf_cells += 1
+                np.testing.assert_almost_equal(outputs[(i, j)], reference[(i, j)])
+            else:
+                np.testing.assert_almost_equal(outputs[(i, j)], (T_melting, 0.0))
+
+        # make sure that all kinds of cells are present
+        assert cell_type[self.ocean] == PISM.MASK_ICE_FREE_OCEAN
+        assert cell_type[(4, 0)] == PISM.MASK_GROUNDED
+        assert 0 < n_shelf_cells < Mx * My
+
+    def tearDown(self):
+        os.remove(self.filename)
+
 class DeltaT(TestCase):
     def setUp(self):
         self.filename = "ocean_delta_T_input.nc"
@@ -0,0 +1,49 @@
+#!/bin/bash
+
+# Test processor independence of the "elevation classes" mode of the PDD surface model.
+# Blocks of 4x4 cells do not match sub-domains of 2 and 3 processes on this grid, so
+# processes have to exchange partial class sums.
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+files="ec-ref.nc ec-input.nc ec-1.nc ec-2.nc ec-3.nc"
+
+rm -f $files
+
+set -e -x
+
+grid="-Mx 31 -My 31 -Mz 11 -Lz 5000"
+
+# reference surface elevation used by lapse rate corrections (nearly ice-free)
+$MPIEXEC -n 1 $PISM_PATH/pisms $grid -y 1 -verbose 1 -o ec-ref.nc
+# an ice sheet with a range of surface elevations
+$MPIEXEC -n 1 $PISM_PATH/pisms $grid -y 3000 -verbose 1 -o ec-input.nc
+
+options="-bootstrap -i ec-input.nc $grid -y 2 -verbose 1 -o_size big
+ -stress_balance none -energy none
+ -surface pdd -pdd_elevation_classes
+ -surface.pdd.elevation_classes.block_size 4
+ -surface.pdd.elevation_classes.bin_width 200
+ -atmosphere uniform,elevation_change -atmosphere_lapse_rate_file ec-ref.nc -temp_lapse_rate 6"
+
+NRANGE="1 2 3"
+
+for NN in $NRANGE;
+do
+    $MPIEXEC -n $NN $PISM_PATH/pismr $options -o ec-$NN.nc
+done
+
+set +e
+
+# Partial class sums are added in a different order, so results may differ by round-off.
+for NN in 2 3;
+do
+    $PISM_PATH/nccmp.py -t 1e-9 -v thk,firn_depth,snow_depth ec-1.nc ec-$NN.nc
+    if [ $? != 0 ];
+    then
+        exit 1
+    fi
+done
+
+rm -f $files; exit 0
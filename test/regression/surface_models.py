@@ -574,9 +574,99 @@ class Cache(TestCase):
         write_state(modifier, self.output_filename)
         probe_interface(modifier)
 
+    def test_surface_cache_period_stateful(self):
+        "Modifier 'cache' refuses to skip updates of models with internal state"
+        models = config.get_string("surface.models")
+        try:
+            config.set_number("surface.cache.period", 4)
+            config.set_string("surface.models", "pdd,cache")
+
+            factory = PISM.SurfaceFactory(self.grid, PISM.AtmosphereUniform(self.grid))
+
+            try:
+                factory.create("pdd,cache")
+                assert False, "failed to stop a 'pdd,cache' run with surface.cache.period > 0"
+            except RuntimeError:
+                pass
+
+            # models without internal state are fine
+            config.set_string("surface.models", "simple,cache")
+            factory.create("simple,cache")
+        finally:
+            config.set_number("surface.cache.period", 0)
+            config.set_string("surface.models", models)
+
     def tearDown(self):
         os.remove(self.filename)
-        os.remove(self.output_filename)
+        if os.path.exists(self.output_filename):
+            os.remove(self.output_filename)
+
+class CacheMemoization(TestCase):
+    "Modifier 'cache' with surface.cache.period > 0"
+    def setUp(self):
+        self.filename = "surface_cache_dT.nc"
+        self.grid = shallow_grid()
+        self.geometry = PISM.Geometry(self.grid)
+
+        self.simple = surface_simple(self.grid)
+        self.delta_T = PISM.SurfaceDeltaT(self.grid, self.simple)
+
+        # offsets are *not* periodic: re-computed outputs differ from stored ones
+        N = 14
+        create_scalar_forcing(self.filename, "delta_T", "Kelvin", np.arange(N) + 1.0,
+                              times=None, time_bounds=np.arange(N + 1) * seconds_per_year)
+
+        config.set_string("surface.delta_T.file", self.filename)
+        config.set_number("surface.cache.update_interval", 1.0)
+        config.set_number("surface.cache.period", 4)
+        config.set_number("surface.cache.surface_elevation_tolerance", 10.0)
+
+    def set_geometry(self, H, H_corner):
+        "Set ice thickness to H everywhere except for (0, 0), where it is set to H_corner."
+        self.geometry.bed_elevation.set(100.0)
+        self.geometry.sea_level_elevation.set(0.0)
+        self.geometry.ice_thickness.set(H)
+        with PISM.vec.Access(nocomm=self.geometry.ice_thickness):
+            for (i, j) in self.grid.points():
+                if i == 0 and j == 0:
+                    self.geometry.ice_thickness[i, j] = H_corner
+        self.geometry.ensure_consistency(0.0)
+
+    def runTest(self):
+        modifier = PISM.SurfaceCache(self.grid, self.delta_T)
+
+        self.set_geometry(1000.0, 0.0)
+        modifier.init(self.geometry)
+
+        # geometry for each year: A (reference), B (surface elevation changed by 100 m
+        # everywhere), C (same as B except for the cell type at (0, 0); the surface
+        # elevation there changed by 5 m)
+        geometries = {"A": (1000.0, 0.0),
+                      "B": (1100.0, 0.0),
+                      "C": (1100.0, 5.0)}
+        years = "AAAA" + "AAAA" + "BBBB" + "C" + "B"
+
+        diff = []
+        for k, g in enumerate(years):
+            self.set_geometry(*geometries[g])
+            modifier.update(self.geometry, k * seconds_per_year, seconds_per_year)
+
+            diff.append(sample(modifier.temperature()) - sample(self.simple.temperature()))
+
+        # 0-3: computed and stored
+        # 4-7: re-used (offsets 5-8 are not used, i.e. the input model was not updated)
+        # 8-11: re-computed (surface elevation changed)
+        # 12: re-computed (cell type changed)
+        # 13: re-uses results stored at year 9
+        np.testing.assert_almost_equal(diff, [1, 2, 3, 4,
+                                              1, 2, 3, 4,
+                                              9, 10, 11, 12,
+                                              13,
+                                              10])
+
+    def tearDown(self):
+        config.set_number("surface.cache.period", 0)
+        os.remove(self.filename)
 
 class ForceThickness(TestCase):
     def setUp(self):
@@ -0,0 +1,44 @@
+#!/bin/bash
+
+# Test writing scalar time series (-ts_file): a small buffer (flushed many times during a
+# run) and synchronizing the file after every flush have to produce the same file,
+# including when a re-started run appends to it.
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+files="ts-leg1-buffer.nc ts-leg1-sync.nc ts-buffer.nc ts-sync.nc ts-o1.nc ts-o2.nc ts-o3.nc ts-o4.nc"
+
+rm -f $files
+
+set -e -x
+
+opts="-Mx 11 -My 11 -Mz 11 -max_dt 1 -verbose 1 -ts_times 0:0.5:20"
+buffer="-ts_file ts-buffer.nc -output.timeseries.buffer_size 3"
+sync="-ts_file ts-sync.nc -output.timeseries.sync"
+
+$MPIEXEC -n 2 $PISM_PATH/pisms $opts -y 10 $buffer -o ts-o1.nc
+$MPIEXEC -n 2 $PISM_PATH/pisms $opts -y 10 $sync -o ts-o2.nc
+
+cp ts-buffer.nc ts-leg1-buffer.nc
+cp ts-sync.nc ts-leg1-sync.nc
+
+# re-start and append
+$MPIEXEC -n 2 $PISM_PATH/pisms $opts -i ts-o1.nc -y 10 $buffer -ts_append -o ts-o3.nc
+$MPIEXEC -n 2 $PISM_PATH/pisms $opts -i ts-o2.nc -y 10 $sync -ts_append -o ts-o4.nc
+
+set +e
+
+# run_stats contains run times
+$PISM_PATH/nccmp.py -x -v run_stats,pism_config ts-leg1-buffer.nc ts-leg1-sync.nc || exit 1
+$PISM_PATH/nccmp.py -x -v run_stats,pism_config ts-buffer.nc ts-sync.nc || exit 1
+
+# check that the second run appended all its records
+/usr/bin/env python3 - <<END || exit 1
+import netCDF4
+time = netCDF4.Dataset("ts-buffer.nc").variables["time"][:]
+assert len(time) == 40, len(time)
+assert all(time[1:] > time[:-1])
+END
+
+rm -f $files; exit 0